@@ -0,0 +1,496 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace execq
+{
+    namespace impl
+    {
+        class IChannelListener
+        {
+        public:
+            virtual ~IChannelListener() = default;
+            
+            /**
+             * @brief Called when value is sent to the channel or the channel is closed.
+             * @discussion Called under the channel lock: must not block or access the channel.
+             */
+            virtual void onChannelReady() = 0;
+        };
+        
+        enum class ChannelPollResult
+        {
+            Received,
+            Empty,
+            Closed
+        };
+        
+        template <typename T>
+        class ChannelSelectCase;
+    }
+    
+    /**
+     * @class Channel
+     * @brief Bounded multi-producer multi-consumer channel.
+     *
+     * @discussion Values are received in the order they are sent.
+     * Besides blocking 'receive', values can be consumed by pool tasks (see CreateChannelReceiver)
+     * or by ChannelSelector across multiple channels.
+     * @templatefield T Type of the value.
+     */
+    template <typename T>
+    class Channel
+    {
+    public:
+        /**
+         * @param capacity Maximum number of values in the channel. Must be greater than zero.
+         */
+        explicit Channel(const size_t capacity);
+        
+        /**
+         * @brief Sends the value, blocking while the channel is full.
+         * @return false if the channel is closed. The value is not sent then.
+         */
+        bool send(T&& value);
+        bool send(const T& value);
+        
+        /**
+         * @brief Sends the value if the channel has free space.
+         * @return false if the channel is full or closed. The value is left untouched then.
+         */
+        bool trySend(T&& value);
+        bool trySend(const T& value);
+        
+        /**
+         * @brief Receives next value, blocking while the channel is empty.
+         * @return false if the channel is closed and has no more values.
+         */
+        bool receive(T& value);
+        
+        /**
+         * @brief Receives next value if any.
+         * @return false if the channel is empty.
+         */
+        bool tryReceive(T& value);
+        
+        /**
+         * @brief Closes the channel. Values sent before still can be received.
+         */
+        void close();
+        bool isClosed() const;
+        
+    public:
+        void addListener(impl::IChannelListener& listener);
+        void removeListener(impl::IChannelListener& listener);
+        
+    private:
+        friend class impl::ChannelSelectCase<T>;
+        
+        impl::ChannelPollResult poll(T& value);
+        
+        template <typename Value>
+        bool sendImpl(Value&& value, const bool shouldWait);
+        void notifyListeners();
+        
+    private:
+        std::deque<T> m_values;
+        bool m_isClosed = false;
+        std::vector<impl::IChannelListener*> m_listeners;
+        
+        mutable std::mutex m_mutex;
+        std::condition_variable m_notEmptyCondition;
+        std::condition_variable m_notFullCondition;
+        
+        const size_t m_capacity;
+    };
+    
+    /**
+     * @class IChannelReceiver
+     * @brief Consumes values of the channel on the execution pool. Destroying the receiver stops consuming.
+     * @discussion When destroyed, waits until values being processed are done. Values left in the channel are not touched.
+     */
+    class IChannelReceiver
+    {
+    public:
+        virtual ~IChannelReceiver() = default;
+    };
+    
+    namespace impl
+    {
+        class IChannelSelectCase
+        {
+        public:
+            virtual ~IChannelSelectCase() = default;
+            
+            virtual ChannelPollResult poll() = 0;
+            virtual void addListener(IChannelListener& listener) = 0;
+            virtual void removeListener(IChannelListener& listener) = 0;
+        };
+        
+        template <typename T>
+        class ChannelSelectCase: public IChannelSelectCase
+        {
+        public:
+            ChannelSelectCase(Channel<T>& channel, std::function<void(T&& value)> handler);
+            
+        public: // IChannelSelectCase
+            virtual ChannelPollResult poll() final;
+            virtual void addListener(IChannelListener& listener) final;
+            virtual void removeListener(IChannelListener& listener) final;
+            
+        private:
+            Channel<T>& m_channel;
+            const std::function<void(T&& value)> m_handler;
+        };
+        
+        class ChannelSelectWaiter: public IChannelListener
+        {
+        public:
+            explicit ChannelSelectWaiter(const std::vector<std::unique_ptr<IChannelSelectCase>>& cases);
+            ~ChannelSelectWaiter();
+            
+            void wait();
+            
+        public: // IChannelListener
+            virtual void onChannelReady() final;
+            
+        private:
+            bool m_isReady = false;
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            
+            const std::vector<std::unique_ptr<IChannelSelectCase>>& m_cases;
+        };
+    }
+    
+    /**
+     * @class ChannelSelector
+     * @brief Receives next value from any of multiple channels.
+     *
+     * @discussion Channels are polled by turn starting after the last selected one, so busy channel doesn't starve others.
+     * Only receive cases are supported.
+     */
+    class ChannelSelector
+    {
+    public:
+        /**
+         * @brief Adds the channel to select from. 'handler' is called with the value received from it.
+         * @discussion The channel must outlive the selector.
+         */
+        template <typename T>
+        ChannelSelector& onReceive(Channel<T>& channel, std::function<void(T&& value)> handler);
+        
+        /**
+         * @brief Blocks until any channel has a value and calls its handler.
+         * @return false if all channels are closed and have no more values.
+         */
+        bool select();
+        
+        /**
+         * @brief Calls the handler of any channel that has a value without waiting.
+         * @return false if no channel has a value.
+         */
+        bool trySelect();
+        
+    private:
+        impl::ChannelPollResult pollAll();
+        
+    private:
+        std::vector<std::unique_ptr<impl::IChannelSelectCase>> m_cases;
+        size_t m_nextCase = 0;
+    };
+}
+
+// Channel
+
+template <typename T>
+execq::Channel<T>::Channel(const size_t capacity)
+: m_capacity(capacity)
+{
+    if (!capacity)
+    {
+        throw std::invalid_argument("Failed to create channel: capacity must be greater than zero.");
+    }
+}
+
+template <typename T>
+bool execq::Channel<T>::send(T&& value)
+{
+    return sendImpl(std::move(value), true);
+}
+
+template <typename T>
+bool execq::Channel<T>::send(const T& value)
+{
+    return sendImpl(value, true);
+}
+
+template <typename T>
+bool execq::Channel<T>::trySend(T&& value)
+{
+    return sendImpl(std::move(value), false);
+}
+
+template <typename T>
+bool execq::Channel<T>::trySend(const T& value)
+{
+    return sendImpl(value, false);
+}
+
+template <typename T>
+bool execq::Channel<T>::receive(T& value)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notEmptyCondition.wait(lock, [this] { return !m_values.empty() || m_isClosed; });
+    if (m_values.empty())
+    {
+        return false;
+    }
+    
+    value = std::move(m_values.front());
+    m_values.pop_front();
+    m_notFullCondition.notify_one();
+    
+    return true;
+}
+
+template <typename T>
+bool execq::Channel<T>::tryReceive(T& value)
+{
+    return poll(value) == impl::ChannelPollResult::Received;
+}
+
+template <typename T>
+void execq::Channel<T>::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_isClosed)
+    {
+        return;
+    }
+    
+    m_isClosed = true;
+    m_notEmptyCondition.notify_all();
+    m_notFullCondition.notify_all();
+    notifyListeners();
+}
+
+template <typename T>
+bool execq::Channel<T>::isClosed() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_isClosed;
+}
+
+template <typename T>
+void execq::Channel<T>::addListener(impl::IChannelListener& listener)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_listeners.push_back(&listener);
+}
+
+template <typename T>
+void execq::Channel<T>::removeListener(impl::IChannelListener& listener)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_listeners.erase(std::remove(m_listeners.begin(), m_listeners.end(), &listener), m_listeners.end());
+}
+
+// Private
+
+template <typename T>
+execq::impl::ChannelPollResult execq::Channel<T>::poll(T& value)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_values.empty())
+    {
+        return m_isClosed ? impl::ChannelPollResult::Closed : impl::ChannelPollResult::Empty;
+    }
+    
+    value = std::move(m_values.front());
+    m_values.pop_front();
+    m_notFullCondition.notify_one();
+    
+    return impl::ChannelPollResult::Received;
+}
+
+template <typename T>
+template <typename Value>
+bool execq::Channel<T>::sendImpl(Value&& value, const bool shouldWait)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (shouldWait)
+    {
+        m_notFullCondition.wait(lock, [this] { return m_values.size() < m_capacity || m_isClosed; });
+    }
+    
+    if (m_isClosed || m_values.size() >= m_capacity)
+    {
+        return false;
+    }
+    
+    m_values.push_back(std::forward<Value>(value));
+    m_notEmptyCondition.notify_one();
+    notifyListeners();
+    
+    return true;
+}
+
+template <typename T>
+void execq::Channel<T>::notifyListeners()
+{
+    for (impl::IChannelListener* listener : m_listeners)
+    {
+        listener->onChannelReady();
+    }
+}
+
+// ChannelSelectCase
+
+template <typename T>
+execq::impl::ChannelSelectCase<T>::ChannelSelectCase(Channel<T>& channel, std::function<void(T&& value)> handler)
+: m_channel(channel)
+, m_handler(std::move(handler))
+{}
+
+template <typename T>
+execq::impl::ChannelPollResult execq::impl::ChannelSelectCase<T>::poll()
+{
+    T value;
+    const ChannelPollResult result = m_channel.poll(value);
+    if (result == ChannelPollResult::Received)
+    {
+        m_handler(std::move(value));
+    }
+    
+    return result;
+}
+
+template <typename T>
+void execq::impl::ChannelSelectCase<T>::addListener(IChannelListener& listener)
+{
+    m_channel.addListener(listener);
+}
+
+template <typename T>
+void execq::impl::ChannelSelectCase<T>::removeListener(IChannelListener& listener)
+{
+    m_channel.removeListener(listener);
+}
+
+// ChannelSelectWaiter
+
+inline execq::impl::ChannelSelectWaiter::ChannelSelectWaiter(const std::vector<std::unique_ptr<IChannelSelectCase>>& cases)
+: m_cases(cases)
+{
+    for (const auto& selectCase : m_cases)
+    {
+        selectCase->addListener(*this);
+    }
+}
+
+inline execq::impl::ChannelSelectWaiter::~ChannelSelectWaiter()
+{
+    for (const auto& selectCase : m_cases)
+    {
+        selectCase->removeListener(*this);
+    }
+}
+
+inline void execq::impl::ChannelSelectWaiter::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return m_isReady; });
+    m_isReady = false;
+}
+
+inline void execq::impl::ChannelSelectWaiter::onChannelReady()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isReady = true;
+    m_condition.notify_one();
+}
+
+// ChannelSelector
+
+template <typename T>
+execq::ChannelSelector& execq::ChannelSelector::onReceive(Channel<T>& channel, std::function<void(T&& value)> handler)
+{
+    m_cases.emplace_back(new impl::ChannelSelectCase<T>(channel, std::move(handler)));
+    return *this;
+}
+
+inline bool execq::ChannelSelector::select()
+{
+    impl::ChannelPollResult result = pollAll();
+    if (result != impl::ChannelPollResult::Empty)
+    {
+        return result == impl::ChannelPollResult::Received;
+    }
+    
+    impl::ChannelSelectWaiter waiter(m_cases);
+    
+    // Channels are polled again after subscribing, so values sent meanwhile are not missed.
+    while ((result = pollAll()) == impl::ChannelPollResult::Empty)
+    {
+        waiter.wait();
+    }
+    
+    return result == impl::ChannelPollResult::Received;
+}
+
+inline bool execq::ChannelSelector::trySelect()
+{
+    return pollAll() == impl::ChannelPollResult::Received;
+}
+
+inline execq::impl::ChannelPollResult execq::ChannelSelector::pollAll()
+{
+    bool allClosed = true;
+    const size_t casesCount = m_cases.size();
+    for (size_t i = 0; i < casesCount; i++)
+    {
+        const size_t caseIndex = (m_nextCase + i) % casesCount;
+        const impl::ChannelPollResult result = m_cases[caseIndex]->poll();
+        if (result == impl::ChannelPollResult::Received)
+        {
+            m_nextCase = caseIndex + 1;
+            return result;
+        }
+        
+        allClosed &= result == impl::ChannelPollResult::Closed;
+    }
+    
+    return allClosed ? impl::ChannelPollResult::Closed : impl::ChannelPollResult::Empty;
+}
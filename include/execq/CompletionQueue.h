@@ -0,0 +1,161 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+namespace execq
+{
+    /**
+     * @brief Result of the object processing posted to CompletionQueue.
+     * @field tag Value passed when the object was pushed.
+     */
+    template <typename R>
+    struct Completion
+    {
+        uint64_t tag;
+        R result;
+    };
+    
+    template <>
+    struct Completion<void>
+    {
+        uint64_t tag;
+    };
+    
+    /**
+     * @class CompletionQueue
+     * @brief Collects results of objects processing in the order they are completed.
+     *
+     * @discussion Push objects into IExecutionQueue with completion queue and a tag instead of waiting for futures one by one.
+     * Consumer thread drains all completions accumulated so far at once.
+     * @discussion Consumer is woken up only when the first completion arrives to the empty queue:
+     * completions posted while the consumer processes previous batch do not cause extra wakeups.
+     * @templatefield R Type of the result of object processing. Can be 'void'.
+     */
+    template <typename R>
+    class CompletionQueue
+    {
+    public:
+        /**
+         * @brief Posts completion. Usually called by IExecutionQueue when the object is processed.
+         */
+        template <typename... Result>
+        void post(const uint64_t tag, Result&&... result);
+        
+        /**
+         * @brief Blocks until there is at least one completion and moves all accumulated completions into 'completions'.
+         * @discussion Completions are appended to 'completions'. Pass the same (cleared) vector to avoid reallocations.
+         * @return Number of completions drained.
+         */
+        size_t drain(std::vector<Completion<R>>& completions);
+        
+        /**
+         * @brief Same as 'drain', but waits no longer than 'timeout'.
+         * @return Number of completions drained. Zero if timed out.
+         */
+        template <typename Rep, typename Period>
+        size_t drainFor(std::vector<Completion<R>>& completions, const std::chrono::duration<Rep, Period>& timeout);
+        
+        /**
+         * @brief Moves all accumulated completions into 'completions' without waiting.
+         * @return Number of completions drained.
+         */
+        size_t tryDrain(std::vector<Completion<R>>& completions);
+        
+    private:
+        size_t takeAll(std::vector<Completion<R>>& completions);
+        
+    private:
+        std::vector<Completion<R>> m_completions;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+    };
+}
+
+template <typename R>
+template <typename... Result>
+void execq::CompletionQueue<R>::post(const uint64_t tag, Result&&... result)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    const bool wasEmpty = m_completions.empty();
+    m_completions.push_back(Completion<R> { tag, std::forward<Result>(result)... });
+    
+    if (wasEmpty)
+    {
+        m_condition.notify_one();
+    }
+}
+
+template <typename R>
+size_t execq::CompletionQueue<R>::drain(std::vector<Completion<R>>& completions)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return !m_completions.empty(); });
+    
+    return takeAll(completions);
+}
+
+template <typename R>
+template <typename Rep, typename Period>
+size_t execq::CompletionQueue<R>::drainFor(std::vector<Completion<R>>& completions, const std::chrono::duration<Rep, Period>& timeout)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait_for(lock, timeout, [this] { return !m_completions.empty(); });
+    
+    return takeAll(completions);
+}
+
+template <typename R>
+size_t execq::CompletionQueue<R>::tryDrain(std::vector<Completion<R>>& completions)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return takeAll(completions);
+}
+
+template <typename R>
+size_t execq::CompletionQueue<R>::takeAll(std::vector<Completion<R>>& completions)
+{
+    const size_t count = m_completions.size();
+    if (completions.empty())
+    {
+        // Buffers are exchanged, so the consumer's vector is reused for next completions.
+        completions.swap(m_completions);
+    }
+    else
+    {
+        std::move(m_completions.begin(), m_completions.end(), std::back_inserter(completions));
+        m_completions.clear();
+    }
+    
+    return count;
+}
@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+namespace execq
+{
+    namespace impl
+    {
+        /**
+         * @brief Callable that passes the result of the first stage directly to the second one.
+         * @discussion Both stages have signature 'R(const std::atomic_bool& isCanceled, T&& object)'.
+         * Calls are resolved at compile time, so the compiler is free to inline the whole chain.
+         */
+        template <typename First, typename Second>
+        class FusedStage
+        {
+        public:
+            FusedStage(First first, Second second)
+            : m_first(std::move(first))
+            , m_second(std::move(second))
+            {}
+            
+            template <typename T>
+            auto operator()(const std::atomic_bool& isCanceled, T&& object) const
+            -> decltype(std::declval<const Second&>()(isCanceled, std::declval<const First&>()(isCanceled, std::forward<T>(object))))
+            {
+                return m_second(isCanceled, m_first(isCanceled, std::forward<T>(object)));
+            }
+            
+        private:
+            First m_first;
+            Second m_second;
+        };
+        
+        template <typename... Stages>
+        struct FusedChain;
+        
+        template <typename Stage>
+        struct FusedChain<Stage>
+        {
+            using Type = Stage;
+            
+            static Type make(Stage stage)
+            {
+                return stage;
+            }
+        };
+        
+        template <typename First, typename Second, typename... Rest>
+        struct FusedChain<First, Second, Rest...>
+        {
+            using Type = typename FusedChain<FusedStage<First, Second>, Rest...>::Type;
+            
+            static Type make(First first, Second second, Rest... rest)
+            {
+                return FusedChain<FusedStage<First, Second>, Rest...>::make(FusedStage<First, Second>(std::move(first), std::move(second)),
+                                                                           std::move(rest)...);
+            }
+        };
+    }
+    
+    /**
+     * @brief Composes cheap stateless stages into single callable that can be used as executor of any queue or pipeline stage.
+     * @discussion Each stage has signature 'R(const std::atomic_bool& isCanceled, T&& object)'
+     * and receives the result of the previous one. Fused chain is executed as single task,
+     * so there is no queue push/pop between the stages.
+     * @discussion Usage:
+     * execq::PipelineBuilder<std::string>(pool)
+     *     .parallel<Record>(64, execq::Fuse(&Trim, &Parse, &Validate))
+     *     .serial<void>(16, &WriteRecord)
+     *     .build();
+     * @discussion Split the chain by pipeline stages where a stage must be serial or is heavy/blocking.
+     */
+    template <typename... Stages>
+    typename impl::FusedChain<typename std::decay<Stages>::type...>::Type Fuse(Stages&&... stages)
+    {
+        return impl::FusedChain<typename std::decay<Stages>::type...>::make(std::forward<Stages>(stages)...);
+    }
+}
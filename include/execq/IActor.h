@@ -0,0 +1,124 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+namespace execq
+{
+    class IActorSystem;
+    
+    namespace impl
+    {
+        class ActorCore;
+        
+        /**
+         * @class IActorScheduler
+         * @brief Methods of the actor system used by the actors.
+         */
+        class IActorScheduler
+        {
+        public:
+            virtual ~IActorScheduler() = default;
+            
+            /**
+             * @brief Schedules actor which mailbox became non-empty.
+             */
+            virtual void schedule(ActorCore& actor) = 0;
+            
+            /**
+             * @brief Blocks until the actor has no pending messages. Used by actors when destroyed.
+             */
+            virtual void waitIdle(const ActorCore& actor) = 0;
+        };
+        
+        IActorScheduler& ActorScheduler(IActorSystem& actorSystem);
+    }
+    
+    /**
+     * @class IActorSystem
+     * @brief Runs actors on the execution pool.
+     *
+     * @discussion Actor system is registered in the pool once. Actors are scheduled into it only while
+     * they have messages, so actors themselves cost no threads and no pool registration.
+     * @discussion Has no public methods: scheduling is available only to the actors.
+     */
+    class IActorSystem
+    {
+    public:
+        virtual ~IActorSystem() = default;
+        
+    private:
+        friend impl::IActorScheduler& impl::ActorScheduler(IActorSystem& actorSystem);
+        
+        virtual impl::IActorScheduler& actorScheduler() = 0;
+    };
+    
+    /**
+     * @class IActor
+     * @brief Processes messages sent to it strictly one-after-one.
+     *
+     * @discussion When destroyed, the actor waits until all messages sent to it are processed.
+     * Messages processed during destruction are marked as canceled.
+     * @templatefield M Type of the message.
+     */
+    template <typename M>
+    class IActor
+    {
+    public:
+        virtual ~IActor() = default;
+        
+        /**
+         * @brief Sends-by-copy the message to the actor. Never blocks.
+         */
+        void send(const M& message);
+        
+        /**
+         * @brief Sends-by-move the message to the actor. Never blocks.
+         */
+        void send(M&& message);
+        
+    private:
+        virtual void sendImpl(M&& message) = 0;
+    };
+}
+
+inline execq::impl::IActorScheduler& execq::impl::ActorScheduler(IActorSystem& actorSystem)
+{
+    return actorSystem.actorScheduler();
+}
+
+template <typename M>
+void execq::IActor<M>::send(const M& message)
+{
+    sendImpl(M(message));
+}
+
+template <typename M>
+void execq::IActor<M>::send(M&& message)
+{
+    sendImpl(std::move(message));
+}
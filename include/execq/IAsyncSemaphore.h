@@ -0,0 +1,147 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+namespace execq
+{
+    class IAsyncSemaphore;
+    
+    namespace impl
+    {
+        class AsyncSemaphore;
+    }
+    
+    /**
+     * @class AsyncPermit
+     * @brief Permit acquired from IAsyncSemaphore. The permit is released when destroyed.
+     * @discussion Move the permit to keep holding it after the continuation returns, i.e. while waiting for async work.
+     */
+    class AsyncPermit
+    {
+    public:
+        AsyncPermit() = default;
+        AsyncPermit(AsyncPermit&& other);
+        AsyncPermit& operator=(AsyncPermit&& other);
+        ~AsyncPermit();
+        
+        AsyncPermit(const AsyncPermit&) = delete;
+        AsyncPermit& operator=(const AsyncPermit&) = delete;
+        
+        /**
+         * @brief Releases the permit before the object is destroyed.
+         */
+        void release();
+        
+        /**
+         * @return true if the object holds the permit.
+         */
+        explicit operator bool() const;
+        
+    private:
+        friend class impl::AsyncSemaphore;
+        
+        explicit AsyncPermit(IAsyncSemaphore& semaphore);
+        
+    private:
+        IAsyncSemaphore* m_semaphore = nullptr;
+    };
+    
+    /**
+     * @class IAsyncSemaphore
+     * @brief Semaphore that suspends continuations instead of threads.
+     *
+     * @discussion Continuation waiting for the permit is just queued. When the permit is released,
+     * the next continuation is scheduled on the execution pool, so no pool thread is blocked by contention.
+     * @discussion Permits are granted in 'acquire' order.
+     * @discussion When destroyed, waits until all continuations are done and all permits are released.
+     * Continuations executed during destruction are marked as canceled.
+     */
+    class IAsyncSemaphore
+    {
+    public:
+        virtual ~IAsyncSemaphore() = default;
+        
+        /**
+         * @brief Calls 'continuation' on the pool as soon as the permit is acquired.
+         */
+        virtual void acquire(std::function<void(const std::atomic_bool& isCanceled, AsyncPermit permit)> continuation) = 0;
+        
+        /**
+         * @brief Acquires the permit if it is available right now and no one waits for it.
+         * @return Acquired permit or empty one.
+         */
+        virtual AsyncPermit tryAcquire() = 0;
+        
+    private:
+        friend class AsyncPermit;
+        
+        virtual void releasePermit() = 0;
+    };
+}
+
+inline execq::AsyncPermit::AsyncPermit(IAsyncSemaphore& semaphore)
+: m_semaphore(&semaphore)
+{}
+
+inline execq::AsyncPermit::AsyncPermit(AsyncPermit&& other)
+: m_semaphore(other.m_semaphore)
+{
+    other.m_semaphore = nullptr;
+}
+
+inline execq::AsyncPermit& execq::AsyncPermit::operator=(AsyncPermit&& other)
+{
+    if (this != &other)
+    {
+        release();
+        m_semaphore = other.m_semaphore;
+        other.m_semaphore = nullptr;
+    }
+    
+    return *this;
+}
+
+inline execq::AsyncPermit::~AsyncPermit()
+{
+    release();
+}
+
+inline void execq::AsyncPermit::release()
+{
+    if (m_semaphore)
+    {
+        m_semaphore->releasePermit();
+        m_semaphore = nullptr;
+    }
+}
+
+inline execq::AsyncPermit::operator bool() const
+{
+    return m_semaphore != nullptr;
+}
@@ -0,0 +1,109 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <future>
+#include <memory>
+
+namespace execq
+{
+    template <typename Unused>
+    class IBarrierExecutionQueue;
+    
+    /**
+     * @class IBarrierExecutionQueue
+     * @brief Concurrent queue where some objects require exclusive access.
+     *
+     * @discussion Shared objects are processed concurrently with each other.
+     * Exclusive object waits until all objects pushed before it are processed, is processed alone,
+     * and only then objects pushed after it are processed.
+     * @discussion Waiting is done by not handing out tasks: no pool thread is blocked.
+     * @templatefield T Type of the object to be processed on the queue.
+     * @templatefield R Type of the result of object processing. Can be 'void'.
+     */
+    template <typename T, typename R>
+    class IBarrierExecutionQueue <R(T)>
+    {
+    public:
+        virtual ~IBarrierExecutionQueue() = default;
+        
+        /**
+         * @brief Pushes-by-copy an object to be processed concurrently with other shared objects.
+         * @return Future object to obtain result when the task is done.
+         */
+        std::future<R> push(const T& object);
+        
+        /**
+         * @brief Pushes-by-move an object to be processed concurrently with other shared objects.
+         * @return Future object to obtain result when the task is done.
+         */
+        std::future<R> push(T&& object);
+        
+        /**
+         * @brief Pushes-by-copy an object to be processed exclusively.
+         * @return Future object to obtain result when the task is done.
+         */
+        std::future<R> pushExclusive(const T& object);
+        
+        /**
+         * @brief Pushes-by-move an object to be processed exclusively.
+         * @return Future object to obtain result when the task is done.
+         */
+        std::future<R> pushExclusive(T&& object);
+        
+        /**
+         * @brief Marks all tasks as canceled.
+         * @discussion Be aware that new tasks added after 'cancel' call will not be marked as 'canceled'.
+         */
+        virtual void cancel() = 0;
+        
+    private:
+        virtual std::future<R> pushImpl(std::unique_ptr<T> object, const bool exclusive) = 0;
+    };
+}
+
+template <typename T, typename R>
+std::future<R> execq::IBarrierExecutionQueue<R(T)>::push(const T& object)
+{
+    return pushImpl(std::unique_ptr<T>(new T { object }), false);
+}
+
+template <typename T, typename R>
+std::future<R> execq::IBarrierExecutionQueue<R(T)>::push(T&& object)
+{
+    return pushImpl(std::unique_ptr<T>(new T { std::move(object) }), false);
+}
+
+template <typename T, typename R>
+std::future<R> execq::IBarrierExecutionQueue<R(T)>::pushExclusive(const T& object)
+{
+    return pushImpl(std::unique_ptr<T>(new T { object }), true);
+}
+
+template <typename T, typename R>
+std::future<R> execq::IBarrierExecutionQueue<R(T)>::pushExclusive(T&& object)
+{
+    return pushImpl(std::unique_ptr<T>(new T { std::move(object) }), true);
+}
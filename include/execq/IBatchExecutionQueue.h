@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace execq
+{
+    /**
+     * @brief Alignment of the first object in each batch of IBatchExecutionQueue.
+     */
+    static const size_t kBatchAlignment = 64;
+    
+    /**
+     * @brief Contiguous batch of objects passed to the IBatchExecutionQueue executor.
+     * @discussion 'objects' is aligned to 'kBatchAlignment'.
+     * @discussion Index of objects[i] (as returned by 'push') is 'firstIndex + i'.
+     */
+    template <typename T>
+    struct ObjectBatch
+    {
+        T* objects;
+        size_t count;
+        uint64_t firstIndex;
+    };
+    
+    /**
+     * @class IBatchExecutionQueue
+     * @brief Queue of trivially copyable objects that are processed in contiguous batches.
+     *
+     * @discussion Objects are copied into chunked buffers without per-object allocations.
+     * The executor receives whole batches, that allows processing them with vectorized (SIMD) code.
+     * @discussion Each object gets sequential index in push order. Use it to trace the result of particular object.
+     * @templatefield T Trivially copyable type of the object to be processed on the queue.
+     */
+    template <typename T>
+    class IBatchExecutionQueue
+    {
+    public:
+        virtual ~IBatchExecutionQueue() = default;
+        
+        /**
+         * @brief Pushes-by-copy an object to be processed on the queue.
+         * @return Index of the object.
+         */
+        virtual uint64_t push(const T& object) = 0;
+        
+        /**
+         * @brief Pushes-by-copy multiple objects to be processed on the queue.
+         * @return Index of the first object. Other objects have sequential indexes.
+         */
+        virtual uint64_t push(const T* objects, const size_t count) = 0;
+        
+        /**
+         * @brief Marks all tasks as canceled.
+         * @discussion Be aware that new tasks added after 'cancel' call will not be marked as 'canceled'.
+         */
+        virtual void cancel() = 0;
+    };
+}
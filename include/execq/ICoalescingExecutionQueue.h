@@ -0,0 +1,85 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <future>
+#include <memory>
+
+namespace execq
+{
+    template <typename Unused>
+    class ICoalescingExecutionQueue;
+    
+    /**
+     * @class ICoalescingExecutionQueue
+     * @brief Queue that keeps at most one pending object per key.
+     *
+     * @discussion If an object with the same key is already waiting for processing,
+     * the pushed object replaces it (or is merged into it) instead of being queued once more.
+     * Both pushes share the same future. Coalesced object keeps the queue position of the pending one.
+     * @discussion Objects that are already being processed are not coalesced.
+     * @templatefield T Type of the object to be processed on the queue.
+     * @templatefield R Type of the result of object processing. Can be 'void'.
+     */
+    template <typename T, typename R>
+    class ICoalescingExecutionQueue <R(T)>
+    {
+    public:
+        virtual ~ICoalescingExecutionQueue() = default;
+        
+        /**
+         * @brief Pushes-by-copy an object to be processed on the queue.
+         * @return Future object shared with all objects coalesced together.
+         */
+        std::shared_future<R> push(const T& object);
+        
+        /**
+         * @brief Pushes-by-move an object to be processed on the queue.
+         * @return Future object shared with all objects coalesced together.
+         */
+        std::shared_future<R> push(T&& object);
+        
+        /**
+         * @brief Marks all tasks as canceled.
+         * @discussion Be aware that new tasks added after 'cancel' call will not be marked as 'canceled'.
+         */
+        virtual void cancel() = 0;
+        
+    private:
+        virtual std::shared_future<R> pushImpl(T&& object) = 0;
+    };
+}
+
+template <typename T, typename R>
+std::shared_future<R> execq::ICoalescingExecutionQueue<R(T)>::push(const T& object)
+{
+    return pushImpl(T(object));
+}
+
+template <typename T, typename R>
+std::shared_future<R> execq::ICoalescingExecutionQueue<R(T)>::push(T&& object)
+{
+    return pushImpl(std::move(object));
+}
@@ -0,0 +1,62 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace execq
+{
+    /**
+     * @brief Defines how signaled values are accumulated until the handler is called.
+     * @field Add Values are summed up (i.e. number of bytes arrived).
+     * @field Or Values are bitwise OR-ed (i.e. mask of changed flags).
+     */
+    enum class EventMerge
+    {
+        Add,
+        Or
+    };
+    
+    /**
+     * @class IEventSource
+     * @brief Merges frequent signals into single handler invocation.
+     *
+     * @discussion Each 'signal' just merges its value into the accumulator with single atomic operation.
+     * If there is no pending handler invocation, it is scheduled on the pool.
+     * The handler receives the value accumulated since its previous invocation.
+     * @discussion Handler invocations never overlap: signals that arrive while the handler is running
+     * are accumulated and delivered with the next invocation.
+     */
+    class IEventSource
+    {
+    public:
+        virtual ~IEventSource() = default;
+        
+        /**
+         * @brief Merges the value into the accumulator. Zero value is ignored.
+         */
+        virtual void signal(const uint64_t value) = 0;
+    };
+}
@@ -24,11 +24,22 @@
 
 #pragma once
 
+#include "execq/CompletionQueue.h"
+#include "execq/IExecutionTarget.h"
+#include "execq/ObjectRecycler.h"
+#include "execq/internal/ObjectPtr.h"
+
 #include <memory>
 #include <future>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
 
 namespace execq
 {
+    class IExecutionPool;
+    
     template <typename Unused>
     class IExecutionQueue;
     
@@ -39,7 +50,7 @@ namespace execq
      * @templatefield R Type of the result of object processing. Can be 'void'.
      */
     template <typename T, typename R>
-    class IExecutionQueue <R(T)>
+    class IExecutionQueue <R(T)>: public IExecutionTarget
     {
     public:
         virtual ~IExecutionQueue() = default;
@@ -58,6 +69,44 @@ namespace execq
          */
         std::future<R> push(T&& object);
         
+        /**
+         * @brief Pushes an object to be processed on the queue taking ownership over it.
+         * @discussion The object is neither copied nor moved.
+         * @discussion You can freely ignore return value: it would not block in future's destructor.
+         * @return Future object to obtain result when the task is done.
+         */
+        std::future<R> push(std::unique_ptr<T> object);
+        
+        /**
+         * @brief Pushes an object to be processed on the queue sharing ownership over it.
+         * @discussion The object is neither copied nor moved. The queue drops its reference when the object is processed.
+         * @discussion Allocates small holder of the reference per push (in addition to the queue's node every push allocates).
+         * @discussion You can freely ignore return value: it would not block in future's destructor.
+         * @return Future object to obtain result when the task is done.
+         */
+        std::future<R> push(std::shared_ptr<T> object);
+        
+        /**
+         * @brief Pushes an object owned by the caller to be processed on the queue.
+         * @discussion The object is neither copied nor moved. It must stay alive until 'release' is called.
+         * @discussion 'release' is called when the object is processed and queue doesn't refer it anymore.
+         * The queue never deletes the object. Throws std::invalid_argument if 'release' is empty.
+         * @discussion Allocates small holder of 'release' per push (in addition to the queue's node every push allocates).
+         * 'release' itself may allocate if its captures don't fit std::function's inline storage.
+         * @discussion You can freely ignore return value: it would not block in future's destructor.
+         * @return Future object to obtain result when the task is done.
+         */
+        std::future<R> pushBorrowed(T& object, std::function<void(T& object)> release);
+        
+        /**
+         * @brief Pushes an object acquired from ObjectRecycler.
+         * @discussion The object is neither copied nor moved. It returns to the recycler when processed.
+         * No allocation is made besides the queue's node: the recycler's slot releases the object itself.
+         * @discussion You can freely ignore return value: it would not block in future's destructor.
+         * @return Future object to obtain result when the task is done.
+         */
+        std::future<R> push(RecycledPtr<T> object);
+        
         /**
          * @brief Emplaces an object to be processed on the queue.
          * @discussion You can freely ignore return value: it would not block in future's destructor.
@@ -66,14 +115,102 @@ namespace execq
         template <typename... Args>
         std::future<R> emplace(Args&&... args);
         
+        /**
+         * @brief Pushes-by-copy an object to be processed on the queue.
+         * @discussion When the object is processed, its result is posted to 'completionQueue' with given 'tag'.
+         */
+        void push(const T& object, std::shared_ptr<CompletionQueue<R>> completionQueue, const uint64_t tag);
+        
+        /**
+         * @brief Pushes-by-move an object to be processed on the queue.
+         * @discussion When the object is processed, its result is posted to 'completionQueue' with given 'tag'.
+         */
+        void push(T&& object, std::shared_ptr<CompletionQueue<R>> completionQueue, const uint64_t tag);
+        
+        /**
+         * @brief Processes-by-copy an object and returns the result.
+         * @discussion If the queue is idle, the object is processed right on the calling thread.
+         * The queue is owned by the caller meanwhile: serial queue doesn't start other tasks.
+         * Otherwise the object is pushed and the call waits until it is processed.
+         * Pool thread helps executing other tasks of the pool while waiting,
+         * unless it executes the task of serial queue or queue with target: helped task could wait for that queue.
+         * @discussion Must not be called from the executor of the same serial queue (or queue it targets).
+         */
+        R dispatchSync(const T& object);
+        
+        /**
+         * @brief Processes-by-move an object and returns the result. See 'dispatchSync(const T&)'.
+         */
+        R dispatchSync(T&& object);
+        
+        /**
+         * @brief Reserves slots for objects pushed with 'tryPushRealtime'.
+         * @discussion Allocates 'capacity' slots and starts the queue's own thread that is woken up by 'tryPushRealtime'.
+         * Must be called once, before any 'tryPushRealtime' call.
+         * @discussion Debounced and throttled queues always wait for the timer, so they ignore the call.
+         */
+        virtual void reserveRealtime(const size_t capacity) = 0;
+        
+        /**
+         * @brief Pushes-by-move an object without taking locks or allocating memory.
+         * @discussion Designed for real-time producers (i.e. audio or market data threads) that must never block.
+         * The object is move-constructed into the slot reserved with 'reserveRealtime',
+         * so the move constructor of 'T' must not allocate as well.
+         * @discussion The result of processing is discarded. Objects pushed this way are processed in their push order,
+         * but not necessarily in order with objects pushed in other ways.
+         * @return false if there is no free slot. The object is left untouched in such case.
+         */
+        virtual bool tryPushRealtime(T&& object) = 0;
+        
         /**
          * @brief Makrs all tasks as canceled.
          * @discussion Be aware that new tasks added after 'cancel' call will not be marked as 'canceled'.
          */
         virtual void cancel() = 0;
         
+        /**
+         * @brief Sets preferred pool threads to execute tasks of the queue.
+         * @discussion Bit N of 'threadMask' corresponds to N-th thread of the execution pool.
+         * Threads out of the mask pick up the task only if all preferred threads have been busy longer than 'spillThreshold'.
+         * @discussion Pass zero 'threadMask' to remove the restriction. Has no effect for pool-independent queues.
+         */
+        virtual void setAffinity(const uint64_t threadMask, const std::chrono::milliseconds spillThreshold) = 0;
+        
+        /**
+         * @brief Moves the queue to another execution pool.
+         * @discussion Pending objects are kept and will be processed on the new pool in the same order.
+         * Tasks being executed at the moment of the call normally continue on the old pool threads.
+         * Serial queue remains serial during and after rebinding.
+         * @param executionPool Pool to execute tasks on. Pass nullptr to make the queue pool-independent.
+         */
+        virtual void rebind(std::shared_ptr<IExecutionPool> executionPool) = 0;
+        
+        /**
+         * @brief Sets the hook that is called for the next pending object each time an object is taken for processing.
+         * @discussion Use it to start bringing the next object's data into the cache (i.e. with prefetch instructions)
+         * while the current object is being processed.
+         * @discussion The next object is taken by the same thread and processed right after the current one,
+         * so the data is brought into the cache of the core that needs it. Up to 16 objects are processed this way in a row.
+         * @discussion The hook is called without the queue's internal lock, but it delays the current object: keep it lightweight.
+         * Must be called before any object is pushed. Pass empty function to remove the hook.
+         */
+        virtual void setPrefetch(std::function<void(const T& object)> prefetch) = 0;
+        
+        /**
+         * @brief Makes the queue execute its objects under constraints of 'target' queue.
+         * @discussion If target is serial, tasks of the target and of all queues targeting it are executed one at a time.
+         * Objects are not moved to the target: the queue keeps its own order, cancellation and pool,
+         * it just doesn't start a task until the target admits it.
+         * @discussion Targets can be chained. The target must outlive the queue.
+         * Must be called before any object is pushed.
+         * @discussion Throws std::invalid_argument if the queue would target itself, directly or through other queues.
+         */
+        virtual void setTarget(IExecutionTarget& target) = 0;
+        
     private:
-        virtual std::future<R> pushImpl(std::unique_ptr<T> object) = 0;
+        virtual R dispatchSyncImpl(T& object) = 0;
+        virtual std::future<R> pushImpl(impl::ObjectPtr<T> object) = 0;
+        virtual void pushImpl(impl::ObjectPtr<T> object, std::shared_ptr<CompletionQueue<R>> completionQueue, const uint64_t tag) = 0;
     };
 }
 
@@ -89,6 +226,71 @@ std::future<R> execq::IExecutionQueue<R(T)>::push(T&& object)
     return pushImpl(std::unique_ptr<T>(new T { std::move(object) }));
 }
 
+template <typename T, typename R>
+std::future<R> execq::IExecutionQueue<R(T)>::push(std::unique_ptr<T> object)
+{
+    if (!object)
+    {
+        throw std::invalid_argument("Failed to push object: object is null.");
+    }
+    
+    return pushImpl(std::move(object));
+}
+
+template <typename T, typename R>
+std::future<R> execq::IExecutionQueue<R(T)>::push(std::shared_ptr<T> object)
+{
+    if (!object)
+    {
+        throw std::invalid_argument("Failed to push object: object is null.");
+    }
+    
+    return pushImpl(impl::ObjectPtr<T>(new impl::SharedObjectReleaser<T>(std::move(object))));
+}
+
+template <typename T, typename R>
+std::future<R> execq::IExecutionQueue<R(T)>::pushBorrowed(T& object, std::function<void(T& object)> release)
+{
+    return pushImpl(impl::ObjectPtr<T>(new impl::BorrowedObjectReleaser<T>(object, std::move(release))));
+}
+
+template <typename T, typename R>
+std::future<R> execq::IExecutionQueue<R(T)>::push(RecycledPtr<T> object)
+{
+    if (!object)
+    {
+        throw std::invalid_argument("Failed to push object: object is null.");
+    }
+    
+    return pushImpl(impl::TakeObjectPtr(object));
+}
+
+template <typename T, typename R>
+void execq::IExecutionQueue<R(T)>::push(const T& object, std::shared_ptr<CompletionQueue<R>> completionQueue, const uint64_t tag)
+{
+    pushImpl(std::unique_ptr<T>(new T { object }), std::move(completionQueue), tag);
+}
+
+template <typename T, typename R>
+void execq::IExecutionQueue<R(T)>::push(T&& object, std::shared_ptr<CompletionQueue<R>> completionQueue, const uint64_t tag)
+{
+    pushImpl(std::unique_ptr<T>(new T { std::move(object) }), std::move(completionQueue), tag);
+}
+
+template <typename T, typename R>
+R execq::IExecutionQueue<R(T)>::dispatchSync(const T& object)
+{
+    T copy(object);
+    return dispatchSync(std::move(copy));
+}
+
+template <typename T, typename R>
+R execq::IExecutionQueue<R(T)>::dispatchSync(T&& object)
+{
+    // The caller waits until the object is processed, so it is borrowed instead of being moved to the heap.
+    return dispatchSyncImpl(object);
+}
+
 template <typename T, typename R>
 template <typename... Args>
 std::future<R> execq::IExecutionQueue<R(T)>::emplace(Args&&... args)
@@ -25,6 +25,8 @@
 #pragma once
 
 #include <memory>
+#include <chrono>
+#include <cstdint>
 
 namespace execq
 {
@@ -56,5 +58,13 @@ namespace execq
          * All tasks being executed during stop will normally continue.
          */
         virtual void stop() = 0;
+        
+        /**
+         * @brief Sets preferred pool threads to execute tasks of the stream.
+         * @discussion Bit N of 'threadMask' corresponds to N-th thread of the execution pool.
+         * Threads out of the mask pick up the task only if all preferred threads have been busy longer than 'spillThreshold'.
+         * @discussion Pass zero 'threadMask' to remove the restriction.
+         */
+        virtual void setAffinity(const uint64_t threadMask, const std::chrono::milliseconds spillThreshold) = 0;
     };
 }
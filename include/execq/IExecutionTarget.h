@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+namespace execq
+{
+    class IExecutionTarget;
+    
+    namespace impl
+    {
+        class IExecutionTargetListener
+        {
+        public:
+            virtual ~IExecutionTargetListener() = default;
+            
+            /**
+             * @brief Called when the target may admit one more task.
+             * @return true if the listener has tasks to execute and has notified the pool.
+             */
+            virtual bool onTargetAvailable() = 0;
+        };
+        
+        
+        /**
+         * @class IExecutionTargetProtocol
+         * @brief Methods of the target used by the queues targeting it.
+         */
+        class IExecutionTargetProtocol
+        {
+        public:
+            virtual ~IExecutionTargetProtocol() = default;
+            
+            /**
+             * @brief Tries to occupy the target for single task of the targeting queue.
+             * @return true if the task may be executed now. Each successful call must be paired with 'leave'.
+             */
+            virtual bool tryEnter() = 0;
+            
+            /**
+             * @brief Frees the target occupied by 'tryEnter'.
+             */
+            virtual void leave() = 0;
+            
+            virtual void addListener(IExecutionTargetListener& listener) = 0;
+            virtual void removeListener(IExecutionTargetListener& listener) = 0;
+            
+            /**
+             * @brief Target of the target itself.
+             * @return nullptr if the target has no target.
+             */
+            virtual IExecutionTargetProtocol* parentTarget() const = 0;
+        };
+        
+        IExecutionTargetProtocol& TargetProtocol(IExecutionTarget& target);
+    }
+    
+    /**
+     * @class IExecutionTarget
+     * @brief Queue that other queues can execute their objects through (see IExecutionQueue::setTarget).
+     *
+     * @discussion Has no public methods: the protocol is available only to the queues targeting this one.
+     */
+    class IExecutionTarget
+    {
+    public:
+        virtual ~IExecutionTarget() = default;
+        
+    private:
+        friend impl::IExecutionTargetProtocol& impl::TargetProtocol(IExecutionTarget& target);
+        
+        virtual impl::IExecutionTargetProtocol& targetProtocol() = 0;
+    };
+}
+
+inline execq::impl::IExecutionTargetProtocol& execq::impl::TargetProtocol(IExecutionTarget& target)
+{
+    return target.targetProtocol();
+}
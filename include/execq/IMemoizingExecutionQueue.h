@@ -0,0 +1,90 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <future>
+#include <memory>
+
+namespace execq
+{
+    template <typename Unused>
+    class IMemoizingExecutionQueue;
+    
+    /**
+     * @class IMemoizingExecutionQueue
+     * @brief Queue that executes equal objects only once.
+     *
+     * @discussion Objects are compared by key. If an object with the same key is being processed (or waits for processing),
+     * pushed object is not queued: the push returns the future of the object already in flight.
+     * @discussion Optionally results stay cached for some time after processing,
+     * and pushes with the same key return the cached result. Objects that failed with an exception are never cached.
+     * @templatefield T Type of the object to be processed on the queue.
+     * @templatefield R Type of the result of object processing. Can be 'void'.
+     */
+    template <typename T, typename R>
+    class IMemoizingExecutionQueue <R(T)>
+    {
+    public:
+        virtual ~IMemoizingExecutionQueue() = default;
+        
+        /**
+         * @brief Pushes-by-copy an object to be processed on the queue.
+         * @return Future object shared with all pushes of the same key.
+         */
+        std::shared_future<R> push(const T& object);
+        
+        /**
+         * @brief Pushes-by-move an object to be processed on the queue.
+         * @return Future object shared with all pushes of the same key.
+         */
+        std::shared_future<R> push(T&& object);
+        
+        /**
+         * @brief Marks all tasks as canceled. Results of canceled tasks are not cached.
+         * @discussion Be aware that new tasks added after 'cancel' call will not be marked as 'canceled'.
+         */
+        virtual void cancel() = 0;
+        
+        /**
+         * @brief Drops all cached results. Objects in flight are not affected.
+         */
+        virtual void clearCache() = 0;
+        
+    private:
+        virtual std::shared_future<R> pushImpl(T&& object) = 0;
+    };
+}
+
+template <typename T, typename R>
+std::shared_future<R> execq::IMemoizingExecutionQueue<R(T)>::push(const T& object)
+{
+    return pushImpl(T(object));
+}
+
+template <typename T, typename R>
+std::shared_future<R> execq::IMemoizingExecutionQueue<R(T)>::push(T&& object)
+{
+    return pushImpl(std::move(object));
+}
@@ -0,0 +1,80 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <functional>
+
+namespace execq
+{
+    namespace impl
+    {
+        template <typename R>
+        struct OrderedCompletion
+        {
+            using Type = std::function<void(R&& result)>;
+        };
+        
+        template <>
+        struct OrderedCompletion<void>
+        {
+            using Type = std::function<void()>;
+        };
+    }
+    
+    /**
+     * @class IOrderedExecutionQueue
+     * @brief Concurrent queue that reports results in the same order objects were pushed.
+     *
+     * @discussion Objects are processed in parallel. Completion function is called
+     * with the result of each object strictly in push order and never concurrently.
+     * @discussion Number of objects pushed but not yet completed is limited by the reorder window.
+     * If single slow object holds up the window, 'push' blocks until it is completed.
+     * @templatefield T Type of the object to be processed.
+     */
+    template <typename T>
+    class IOrderedExecutionQueue
+    {
+    public:
+        virtual ~IOrderedExecutionQueue() = default;
+        
+        /**
+         * @brief Pushes-by-move an object to be processed on the queue.
+         * @discussion Blocks while the reorder window is full.
+         */
+        virtual void push(T&& object) = 0;
+        
+        /**
+         * @brief Pushes-by-move an object to be processed on the queue.
+         * @return false if the reorder window is full. In this case the object is left untouched.
+         */
+        virtual bool tryPush(T&& object) = 0;
+        
+        /**
+         * @brief Marks all tasks in the queue as canceled.
+         * @discussion Be aware that new objects added after 'cancel' call will not be marked as 'canceled'.
+         */
+        virtual void cancel() = 0;
+    };
+}
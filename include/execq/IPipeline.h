@@ -0,0 +1,164 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <functional>
+
+namespace execq
+{
+    class IExecutionPool;
+    
+    namespace impl
+    {
+        class IPipelineStage;
+        
+        template <typename T>
+        class IPipelineInput;
+        
+        template <typename T>
+        class IPipelineOutput;
+        
+        template <typename In, typename Out>
+        struct PipelineExecutor
+        {
+            using Type = std::function<Out(const std::atomic_bool& isCanceled, In&& object)>;
+        };
+        
+        /// No stages can be added after the stage without result.
+        struct PipelineEnd;
+        
+        template <typename Out>
+        struct PipelineExecutor<void, Out>
+        {
+            using Type = PipelineEnd;
+        };
+    }
+    
+    /**
+     * @class IPipeline
+     * @brief Chain of stages that process objects one after another with flow control between them.
+     *
+     * @discussion Each stage has bounded buffer of objects waiting to be processed.
+     * Stage takes next object only if the next stage has free space in its buffer.
+     * If the last stages are slow, buffers of the previous stages fill up and finally 'push' blocks.
+     * @discussion All stages are executed on the same IExecutionPool.
+     * @templatefield T Type of the object to be processed by the first stage.
+     */
+    template <typename T>
+    class IPipeline
+    {
+    public:
+        virtual ~IPipeline() = default;
+        
+        /**
+         * @brief Pushes-by-move an object to be processed on the pipeline.
+         * @discussion Blocks while the buffer of the first stage is full.
+         */
+        virtual void push(T&& object) = 0;
+        
+        /**
+         * @brief Pushes-by-move an object to be processed on the pipeline.
+         * @return false if the buffer of the first stage is full. In this case the object is left untouched.
+         */
+        virtual bool tryPush(T&& object) = 0;
+        
+        /**
+         * @brief Marks all objects being processed on the pipeline as canceled.
+         * @discussion Be aware that new objects added after 'cancel' call will not be marked as 'canceled'.
+         */
+        virtual void cancel() = 0;
+    };
+    
+    /**
+     * @class PipelineBuilder
+     * @brief Builds IPipeline stage by stage.
+     *
+     * @discussion Usage:
+     * std::unique_ptr<IPipeline<std::string>> pipeline = execq::PipelineBuilder<std::string>(pool)
+     *     .parallel<Record>(64, &ParseRecord)
+     *     .serial<void>(16, &WriteRecord)
+     *     .build();
+     *
+     * @discussion Objects are moved from stage to stage. Results of the last stage are discarded.
+     * @discussion Adding a stage moves all stages to the returned builder, 'build' moves them to the pipeline.
+     * Adding one more stage to the builder already used that way (or building it) raises std::logic_error.
+     * @templatefield In Type of the object to be pushed into the pipeline.
+     * @templatefield Out Type of the object produced by the last stage added so far.
+     */
+    template <typename In, typename Out = In>
+    class PipelineBuilder
+    {
+    public:
+        /**
+         * @brief Creates builder of the pipeline that runs on 'executionPool'.
+         * @discussion Throws std::invalid_argument if 'executionPool' is null.
+         */
+        explicit PipelineBuilder(std::shared_ptr<IExecutionPool> executionPool);
+        
+        /**
+         * @brief Moves all stages to the new builder. The source builder is marked as used.
+         */
+        PipelineBuilder(PipelineBuilder&& other);
+        
+        /**
+         * @brief Adds stage that processes objects in serial (one-after-one) order.
+         * @param capacity Maximum number of objects waiting to be processed by the stage.
+         */
+        template <typename Next>
+        PipelineBuilder<In, Next> serial(const size_t capacity, typename impl::PipelineExecutor<Out, Next>::Type executor);
+        
+        /**
+         * @brief Adds stage that processes objects concurrently.
+         * @param capacity Maximum number of objects waiting to be processed by the stage.
+         */
+        template <typename Next>
+        PipelineBuilder<In, Next> parallel(const size_t capacity, typename impl::PipelineExecutor<Out, Next>::Type executor);
+        
+        /**
+         * @brief Creates the pipeline. Exception is raised if there are no stages.
+         */
+        std::unique_ptr<IPipeline<In>> build();
+        
+    private:
+        template <typename, typename>
+        friend class PipelineBuilder;
+        
+        template <typename Next>
+        PipelineBuilder<In, Next> addStage(const bool serial, const size_t capacity,
+                                           typename impl::PipelineExecutor<Out, Next>::Type executor);
+        
+        void checkNotUsed() const;
+        
+    private:
+        std::shared_ptr<IExecutionPool> m_executionPool;
+        std::vector<std::unique_ptr<impl::IPipelineStage>> m_stages;
+        impl::IPipelineInput<In>* m_input = nullptr;
+        impl::IPipelineOutput<Out>* m_output = nullptr;
+        bool m_isUsed = false;
+    };
+}
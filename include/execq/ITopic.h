@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+
+namespace execq
+{
+    /**
+     * @brief Options of the topic subscription.
+     * @field ordered If true, events are handled one-after-one in publish order. Otherwise handled concurrently.
+     * @field maxLag Maximum number of events waiting to be handled by the subscriber.
+     * When exceeded, the oldest waiting event is dropped for this subscriber only. Zero means no limit.
+     */
+    struct SubscriptionOptions
+    {
+        bool ordered = true;
+        size_t maxLag = 0;
+    };
+    
+    /**
+     * @class ISubscription
+     * @brief Subscription to ITopic. Destroying the subscription unsubscribes.
+     * @discussion When destroyed, waits until all events delivered to the subscriber are handled.
+     * Events handled during destruction are marked as canceled.
+     */
+    class ISubscription
+    {
+    public:
+        virtual ~ISubscription() = default;
+        
+        /**
+         * @brief Number of events dropped because the subscriber lagged behind more than 'maxLag'.
+         */
+        virtual uint64_t droppedCount() const = 0;
+    };
+    
+    /**
+     * @class ITopic
+     * @brief Delivers each published event to all subscribers.
+     *
+     * @discussion The event is stored once and shared between subscribers.
+     * Each subscriber handles events in its own pool tasks, so slow subscribers do not delay others.
+     * @templatefield T Type of the event.
+     */
+    template <typename T>
+    class ITopic
+    {
+    public:
+        virtual ~ITopic() = default;
+        
+        /**
+         * @brief Publishes-by-copy the event to all current subscribers.
+         */
+        void publish(const T& event);
+        
+        /**
+         * @brief Publishes-by-move the event to all current subscribers.
+         */
+        void publish(T&& event);
+        
+        /**
+         * @brief Publishes already shared event to all current subscribers. The event is not copied.
+         */
+        void publish(std::shared_ptr<const T> event);
+        
+        /**
+         * @brief Subscribes 'handler' to events published after this call.
+         * @return Subscription object. The handler is called until it is destroyed.
+         */
+        virtual std::unique_ptr<ISubscription> subscribe(std::function<void(const std::atomic_bool& isCanceled, const T& event)> handler,
+                                                         const SubscriptionOptions& options = SubscriptionOptions()) = 0;
+        
+    private:
+        virtual void publishImpl(std::shared_ptr<const T> event) = 0;
+    };
+}
+
+template <typename T>
+void execq::ITopic<T>::publish(const T& event)
+{
+    publishImpl(std::make_shared<const T>(event));
+}
+
+template <typename T>
+void execq::ITopic<T>::publish(T&& event)
+{
+    publishImpl(std::make_shared<const T>(std::move(event)));
+}
+
+template <typename T>
+void execq::ITopic<T>::publish(std::shared_ptr<const T> event)
+{
+    if (!event)
+    {
+        throw std::invalid_argument("Failed to publish event: event is null.");
+    }
+    
+    publishImpl(std::move(event));
+}
@@ -0,0 +1,294 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/internal/ObjectPtr.h"
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+namespace execq
+{
+    template <typename T>
+    class RecycledPtr;
+    
+    namespace impl
+    {
+        template <typename T>
+        ObjectPtr<T> TakeObjectPtr(RecycledPtr<T>& object);
+    }
+    
+    /**
+     * @class RecycledPtr
+     * @brief Pointer to the object acquired from ObjectRecycler.
+     * @discussion When destroyed (i.e. after the object is processed on the queue), the object returns to its recycler.
+     */
+    template <typename T>
+    class RecycledPtr
+    {
+    public:
+        RecycledPtr() = default;
+        RecycledPtr(std::nullptr_t);
+        
+        RecycledPtr(RecycledPtr&& other) = default;
+        RecycledPtr& operator=(RecycledPtr&& other) = default;
+        
+        T* get() const;
+        T& operator*() const;
+        T* operator->() const;
+        explicit operator bool() const;
+        
+        /**
+         * @brief Returns the object to its recycler.
+         */
+        void reset();
+        
+        bool operator==(std::nullptr_t) const;
+        bool operator!=(std::nullptr_t) const;
+        
+    private:
+        template <typename U>
+        friend class ObjectRecycler;
+        friend impl::ObjectPtr<T> impl::TakeObjectPtr<T>(RecycledPtr<T>& object);
+        
+        explicit RecycledPtr(impl::ObjectPtr<T> object);
+        
+    private:
+        impl::ObjectPtr<T> m_object;
+    };
+    
+    /**
+     * @class ObjectRecycler
+     * @brief Producer-side free list of objects to be pushed into the queues without repeated allocations.
+     *
+     * @discussion Objects acquired from the recycler return back to it when processed instead of being deallocated.
+     * Next 'acquire' call reuses them, so large objects (i.e. buffers) are allocated only once.
+     * @discussion Returning objects is lock-free and may happen on any thread.
+     * 'acquire' must not be called concurrently: usually each producer owns its own recycler.
+     * @discussion Recycled objects are returned as they were left after processing (possibly moved-from).
+     */
+    template <typename T>
+    class ObjectRecycler
+    {
+    public:
+        ObjectRecycler();
+        
+        /**
+         * @brief Acquires previously recycled object or creates new one with given arguments.
+         * @discussion Arguments are used only if there are no recycled objects.
+         */
+        template <typename... Args>
+        RecycledPtr<T> acquire(Args&&... args);
+        
+    private:
+        class State;
+        class Slot: public impl::IObjectReleaser<T>
+        {
+        public:
+            template <typename... Args>
+            Slot(Args&&... args);
+            
+            virtual T& object() final;
+            virtual void release() final;
+            
+        public:
+            T value;
+            Slot* next = nullptr;
+            
+            /**
+             * @brief Set while the object is acquired, so the state outlives all objects being processed.
+             */
+            std::shared_ptr<State> owner;
+        };
+        
+        class State
+        {
+        public:
+            ~State();
+            
+            void recycle(Slot* slot);
+            Slot* take();
+            
+        private:
+            static void DeleteSlots(Slot* slot);
+            
+        private:
+            std::atomic<Slot*> m_recycled { nullptr };
+            Slot* m_cached = nullptr;
+        };
+        
+    private:
+        const std::shared_ptr<State> m_state;
+    };
+}
+
+// RecycledPtr
+
+template <typename T>
+execq::RecycledPtr<T>::RecycledPtr(std::nullptr_t)
+{}
+
+template <typename T>
+execq::RecycledPtr<T>::RecycledPtr(impl::ObjectPtr<T> object)
+: m_object(std::move(object))
+{}
+
+template <typename T>
+T* execq::RecycledPtr<T>::get() const
+{
+    return m_object.get();
+}
+
+template <typename T>
+T& execq::RecycledPtr<T>::operator*() const
+{
+    return *m_object;
+}
+
+template <typename T>
+T* execq::RecycledPtr<T>::operator->() const
+{
+    return m_object.get();
+}
+
+template <typename T>
+execq::RecycledPtr<T>::operator bool() const
+{
+    return static_cast<bool>(m_object);
+}
+
+template <typename T>
+void execq::RecycledPtr<T>::reset()
+{
+    m_object.reset();
+}
+
+template <typename T>
+bool execq::RecycledPtr<T>::operator==(std::nullptr_t) const
+{
+    return !m_object;
+}
+
+template <typename T>
+bool execq::RecycledPtr<T>::operator!=(std::nullptr_t) const
+{
+    return static_cast<bool>(m_object);
+}
+
+template <typename T>
+execq::impl::ObjectPtr<T> execq::impl::TakeObjectPtr(RecycledPtr<T>& object)
+{
+    return std::move(object.m_object);
+}
+
+// ObjectRecycler
+
+template <typename T>
+execq::ObjectRecycler<T>::ObjectRecycler()
+: m_state(std::make_shared<State>())
+{}
+
+template <typename T>
+template <typename... Args>
+execq::RecycledPtr<T> execq::ObjectRecycler<T>::acquire(Args&&... args)
+{
+    Slot* slot = m_state->take();
+    if (!slot)
+    {
+        slot = new Slot(std::forward<Args>(args)...);
+    }
+    
+    slot->owner = m_state;
+    return RecycledPtr<T>(impl::ObjectPtr<T>(slot));
+}
+
+// Slot
+
+template <typename T>
+template <typename... Args>
+execq::ObjectRecycler<T>::Slot::Slot(Args&&... args)
+: value(std::forward<Args>(args)...)
+{}
+
+template <typename T>
+T& execq::ObjectRecycler<T>::Slot::object()
+{
+    return value;
+}
+
+template <typename T>
+void execq::ObjectRecycler<T>::Slot::release()
+{
+    // Recycled slot may be deleted with the state, so the state is kept alive until the slot is returned.
+    const std::shared_ptr<State> owner = std::move(this->owner);
+    owner->recycle(this);
+}
+
+// State
+template <typename T>
+execq::ObjectRecycler<T>::State::~State()
+{
+    DeleteSlots(m_cached);
+    DeleteSlots(m_recycled.load());
+}
+
+template <typename T>
+void execq::ObjectRecycler<T>::State::recycle(Slot* slot)
+{
+    slot->next = m_recycled.load(std::memory_order_relaxed);
+    while (!m_recycled.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed))
+    {}
+}
+
+template <typename T>
+typename execq::ObjectRecycler<T>::Slot* execq::ObjectRecycler<T>::State::take()
+{
+    // Grab all recycled slots at once: single consumer never faces ABA problem.
+    if (!m_cached)
+    {
+        m_cached = m_recycled.exchange(nullptr, std::memory_order_acquire);
+    }
+    
+    Slot* const slot = m_cached;
+    if (slot)
+    {
+        m_cached = slot->next;
+        slot->next = nullptr;
+    }
+    
+    return slot;
+}
+
+template <typename T>
+void execq::ObjectRecycler<T>::State::DeleteSlots(Slot* slot)
+{
+    while (slot)
+    {
+        Slot* const next = slot->next;
+        delete slot;
+        slot = next;
+    }
+}
@@ -25,11 +25,27 @@
 #pragma once
 
 #include "IExecutionQueue.h"
+#include "IBatchExecutionQueue.h"
+#include "IBarrierExecutionQueue.h"
+#include "IOrderedExecutionQueue.h"
+#include "ICoalescingExecutionQueue.h"
+#include "IMemoizingExecutionQueue.h"
 #include "IExecutionStream.h"
+#include "IEventSource.h"
+#include "ITopic.h"
+#include "Channel.h"
+#include "IActor.h"
+#include "IAsyncSemaphore.h"
+#include "IPipeline.h"
+#include "FusedStage.h"
+#include "ObjectRecycler.h"
+#include "CompletionQueue.h"
 
 #include <atomic>
 #include <memory>
+#include <future>
 #include <functional>
+#include <type_traits>
 
 namespace execq
 {
@@ -51,6 +67,44 @@ namespace execq
      * @param threadCount Number of threads for execution context. If number of threads less than 2, exeption will be raised.
      */
     std::shared_ptr<IExecutionPool> CreateExecutionPool(const uint32_t threadCount);
+    
+    /**
+     * @brief Returns process-wide pool with hardware-optimal number of threads.
+     * @discussion The pool is created on first call and lives until the process exits.
+     */
+    std::shared_ptr<IExecutionPool> DefaultExecutionPool();
+    
+    
+    
+    /**
+     * @brief Executes ad-hoc function on the pool without creating a queue.
+     * @discussion All functions submitted to the pool go through single internal concurrent queue,
+     * so there is no provider registration or thread per call.
+     * Small functions (i.e. lambdas capturing few pointers) are stored without separate memory allocation.
+     * @return Future object to obtain result (or exception) of the function.
+     */
+    template <typename F>
+    std::future<typename std::result_of<F()>::type> Async(std::shared_ptr<IExecutionPool> executionPool, F&& function);
+    
+    /**
+     * @brief Executes ad-hoc function on the default pool. See 'Async(executionPool, function)'.
+     */
+    template <typename F>
+    std::future<typename std::result_of<F()>::type> Async(F&& function);
+    
+    /**
+     * @brief Executes ad-hoc function on the pool when the result is not needed.
+     * @discussion Unlike 'Async', doesn't create shared state for the future.
+     * Exceptions thrown by the function are ignored.
+     */
+    template <typename F>
+    void Post(std::shared_ptr<IExecutionPool> executionPool, F&& function);
+    
+    /**
+     * @brief Executes ad-hoc function on the default pool. See 'Post(executionPool, function)'.
+     */
+    template <typename F>
+    void Post(F&& function);
 
     
     
@@ -65,6 +119,20 @@ namespace execq
     std::unique_ptr<IExecutionQueue<R(T)>> CreateConcurrentExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
                                                                           std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor);
     
+    /**
+     * @brief Creates concurrent queue that prefers to process objects with the same key back-to-back on the same thread.
+     * @discussion Works like usual concurrent queue, but the thread that has processed an object
+     * prefers next pending object with the same key (as returned by 'localityKey') to benefit from the warm cache.
+     * @discussion Order of objects is not guaranteed, as with usual concurrent queue.
+     * @param localityWindow Number of first pending objects to look up same-key object among.
+     * Also limits the number of objects that are processed in a row this way.
+     */
+    template <typename T, typename R>
+    std::unique_ptr<IExecutionQueue<R(T)>> CreateConcurrentExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                          std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                                                          std::function<size_t(const T& object)> localityKey,
+                                                                          const size_t localityWindow);
+    
     /**
      * @brief Creates serial queue with specific processing function.
      * @discussion All objects pushed into this queue will be processed on either one of pool threads or on the queue-specific thread.
@@ -85,6 +153,144 @@ namespace execq
     template <typename T, typename R>
     std::unique_ptr<IExecutionQueue<R(T)>> CreateSerialExecutionQueue(std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor);
     
+    /**
+     * @brief Creates concurrent queue with processing function of any callable type, including move-only ones.
+     * @discussion The callable is stored without std::function: small callables don't require memory allocation.
+     * Move-only results are supported as well.
+     */
+    template <typename T, typename R, typename F>
+    std::unique_ptr<IExecutionQueue<R(T)>> CreateConcurrentExecutionQueue(std::shared_ptr<IExecutionPool> executionPool, F&& executor);
+    
+    /**
+     * @brief Creates serial queue with processing function of any callable type, including move-only ones.
+     * @discussion See 'CreateConcurrentExecutionQueue(executionPool, F&& executor)'.
+     */
+    template <typename T, typename R, typename F>
+    std::unique_ptr<IExecutionQueue<R(T)>> CreateSerialExecutionQueue(std::shared_ptr<IExecutionPool> executionPool, F&& executor);
+    
+    /**
+     * @brief Creates pool-independent serial queue with processing function of any callable type, including move-only ones.
+     * @discussion See 'CreateConcurrentExecutionQueue(executionPool, F&& executor)'.
+     */
+    template <typename T, typename R, typename F>
+    std::unique_ptr<IExecutionQueue<R(T)>> CreateSerialExecutionQueue(F&& executor);
+    
+    
+    /**
+     * @brief Creates concurrent queue that calls 'completion' with results in the same order objects were pushed.
+     * @discussion Objects are processed in parallel on pool threads or on the queue-specific thread.
+     * 'completion' is called on the thread that has processed the object, never concurrently.
+     * @param reorderWindow Maximum number of objects pushed but not yet completed.
+     * If the window is full (i.e. the oldest object is still being processed), 'push' blocks.
+     * @discussion Throws std::invalid_argument if 'executionPool' is null.
+     */
+    template <typename T, typename R>
+    std::unique_ptr<IOrderedExecutionQueue<T>> CreateOrderedExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                           const size_t reorderWindow,
+                                                                           std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                                                           typename impl::OrderedCompletion<R>::Type completion);
+    
+    
+    /**
+     * @brief Creates concurrent queue that keeps at most one pending object per key.
+     * @discussion Pushing an object with the same key as the pending one replaces it
+     * or, if 'merge' is specified, merges the pushed object into the pending one.
+     * All pushes coalesced together share the same future.
+     * @discussion Suitable for 'last-write-wins' updates that would otherwise be processed multiple times.
+     * @discussion Throws std::invalid_argument if 'executionPool' is null.
+     */
+    template <typename K, typename T, typename R>
+    std::unique_ptr<ICoalescingExecutionQueue<R(T)>> CreateCoalescingExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                                    std::function<K(const T& object)> keyExtractor,
+                                                                                    std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                                                                    std::function<void(T& pending, T&& object)> merge = nullptr);
+    
+    
+    /**
+     * @brief Creates concurrent queue that executes objects with equal keys only once.
+     * @discussion Pushes of the key that is already in flight share its execution and its future.
+     * @param cacheCapacity Number of recently computed results to keep. Zero disables caching:
+     * only objects in flight are shared.
+     * @param cacheTtl Time during which cached result is returned. Zero means results do not expire.
+     * @discussion Throws std::invalid_argument if 'executionPool' is null.
+     */
+    template <typename K, typename T, typename R>
+    std::unique_ptr<IMemoizingExecutionQueue<R(T)>> CreateMemoizingExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                                  std::function<K(const T& object)> keyExtractor,
+                                                                                  std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                                                                  const size_t cacheCapacity = 0,
+                                                                                  const std::chrono::milliseconds cacheTtl = std::chrono::milliseconds::zero());
+    
+    
+    /**
+     * @brief Creates serial queue that processes an object only after 'quietPeriod' passed without new pushes.
+     * @discussion Only the latest object of the burst is processed. Its result is delivered to all pushes of the burst,
+     * so non-void 'R' must be copyable.
+     * @discussion Waiting is done by the timer of the execution pool: no thread sleeps for the queue.
+     */
+    template <typename T, typename R>
+    std::unique_ptr<IExecutionQueue<R(T)>> CreateDebouncedExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                         const std::chrono::milliseconds quietPeriod,
+                                                                         std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor);
+    
+    /**
+     * @brief Creates serial queue that processes at most one object per 'window'.
+     * @discussion The first object is processed immediately. Objects pushed later within the window are
+     * replaced with the latest one that is processed when the window ends. Its result is delivered to all
+     * replaced pushes, so non-void 'R' must be copyable.
+     * @discussion Waiting is done by the timer of the execution pool: no thread sleeps for the queue.
+     */
+    template <typename T, typename R>
+    std::unique_ptr<IExecutionQueue<R(T)>> CreateThrottledExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                         const std::chrono::milliseconds window,
+                                                                         std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor);
+    
+    
+    /**
+     * @brief Creates queue that processes trivially copyable objects in contiguous batches.
+     * @discussion Batches are processed concurrently on pool threads or on the queue-specific thread.
+     * @discussion Full batches contain 'batchSize' objects. If there is a free thread, it takes
+     * accumulated objects as a partial batch instead of waiting for the batch to be filled.
+     * Push objects in bulk to get full batches.
+     * @discussion Throws std::invalid_argument if 'executionPool' is null.
+     */
+    template <typename T>
+    std::unique_ptr<IBatchExecutionQueue<T>> CreateBatchExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                       const size_t batchSize,
+                                                                       std::function<void(const std::atomic_bool& isCanceled, ObjectBatch<T> batch)> executor);
+    
+    
+    /**
+     * @brief Creates concurrent execution queue where objects can be pushed as shared or exclusive.
+     * @discussion Shared objects are processed concurrently. Exclusive object is processed alone,
+     * after all objects pushed before it and before all objects pushed after it.
+     * @discussion Throws std::invalid_argument if 'executionPool' is null.
+     */
+    template <typename T, typename R>
+    std::unique_ptr<IBarrierExecutionQueue<R(T)>> CreateBarrierExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                              std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor);
+    
+    
+    /**
+     * @brief Creates topic that delivers published events to subscribers on the pool.
+     * @discussion Each event is stored once and shared by all subscribers.
+     * @discussion Throws std::invalid_argument if 'executionPool' is null.
+     */
+    template <typename T>
+    std::unique_ptr<ITopic<T>> CreateTopic(std::shared_ptr<IExecutionPool> executionPool);
+    
+    
+    /**
+     * @brief Creates receiver that processes values of the channel on the pool as soon as they are sent.
+     * @discussion No thread is blocked waiting for the values. Values are processed concurrently.
+     * Multiple receivers and 'receive' calls can consume the same channel.
+     * @discussion Throws std::invalid_argument if 'executionPool' is null.
+     */
+    template <typename T>
+    std::unique_ptr<IChannelReceiver> CreateChannelReceiver(std::shared_ptr<IExecutionPool> executionPool,
+                                                            std::shared_ptr<Channel<T>> channel,
+                                                            std::function<void(const std::atomic_bool& isCanceled, T&& value)> handler);
+    
     
     /**
      * @brief Creates execution stream with specific executee function. Stream is stopped by default.
@@ -95,6 +301,50 @@ namespace execq
     std::unique_ptr<IExecutionStream> CreateExecutionStream(std::shared_ptr<IExecutionPool> executionPool,
                                                             std::function<void(const std::atomic_bool& isCanceled)> executee);
     
+    /**
+     * @brief Creates execution stream with executee function of any callable type, including move-only ones.
+     * @discussion See 'CreateConcurrentExecutionQueue(executionPool, F&& executor)'.
+     */
+    template <typename F>
+    std::unique_ptr<IExecutionStream> CreateExecutionStream(std::shared_ptr<IExecutionPool> executionPool, F&& executee);
+    
+    /**
+     * @brief Creates semaphore with 'permitCount' permits that runs continuations of acquirers on the pool.
+     * @discussion Contended acquirers are queued instead of blocking pool threads.
+     * @discussion Throws std::invalid_argument if 'executionPool' is null.
+     */
+    std::unique_ptr<IAsyncSemaphore> CreateAsyncSemaphore(std::shared_ptr<IExecutionPool> executionPool, const size_t permitCount);
+    
+    /**
+     * @brief Creates async mutex, i.e. semaphore with single permit.
+     */
+    std::unique_ptr<IAsyncSemaphore> CreateAsyncMutex(std::shared_ptr<IExecutionPool> executionPool);
+    
+    /**
+     * @brief Creates actor system that runs actors on the pool.
+     * @param messageBudget Maximum number of messages processed by an actor before it yields the thread to other actors.
+     * @discussion Throws std::invalid_argument if 'executionPool' is null.
+     */
+    std::shared_ptr<IActorSystem> CreateActorSystem(std::shared_ptr<IExecutionPool> executionPool, const size_t messageBudget = 64);
+    
+    /**
+     * @brief Creates actor that processes messages one-after-one on the actor system.
+     * @discussion Actor costs neither a thread nor pool registration: it is scheduled only while its mailbox is non-empty.
+     */
+    template <typename M>
+    std::unique_ptr<IActor<M>> CreateActor(std::shared_ptr<IActorSystem> actorSystem,
+                                           std::function<void(const std::atomic_bool& isCanceled, M&& message)> handler);
+    
+    /**
+     * @brief Creates event source that merges signaled values and calls 'handler' with the accumulated value.
+     * @discussion At most one handler invocation is pending or running at a time, regardless of signals frequency.
+     * @discussion Handler is not designed to execute long-term tasks like waiting some event etc.
+     * @discussion Throws std::invalid_argument if 'executionPool' is null.
+     */
+    std::unique_ptr<IEventSource> CreateEventSource(std::shared_ptr<IExecutionPool> executionPool,
+                                                    const EventMerge merge,
+                                                    std::function<void(const std::atomic_bool& isCanceled, const uint64_t value)> handler);
+    
 }
 
 #include "execq/internal/execq_private.h"
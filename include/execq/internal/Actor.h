@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/internal/ActorSystem.h"
+
+namespace execq
+{
+    namespace impl
+    {
+        template <typename M>
+        struct ActorEnvelope: MailboxNode
+        {
+            explicit ActorEnvelope(M&& message)
+            : message(std::move(message))
+            {}
+            
+            M message;
+        };
+        
+        template <typename M>
+        class Actor: public IActor<M>, private ActorCore
+        {
+        public:
+            Actor(std::shared_ptr<IActorSystem> actorSystem,
+                  std::function<void(const std::atomic_bool& isCanceled, M&& message)> handler);
+            ~Actor();
+            
+        private: // IActor
+            virtual void sendImpl(M&& message) final;
+            
+        private: // ActorCore
+            virtual void handle(MailboxNode* message) final;
+            
+        private:
+            std::atomic_bool m_isCanceled { false };
+            
+            const std::shared_ptr<IActorSystem> m_actorSystem;
+            const std::function<void(const std::atomic_bool& isCanceled, M&& message)> m_handler;
+        };
+    }
+}
+
+template <typename M>
+execq::impl::Actor<M>::Actor(std::shared_ptr<IActorSystem> actorSystem,
+                             std::function<void(const std::atomic_bool& isCanceled, M&& message)> handler)
+: m_actorSystem(actorSystem)
+, m_handler(std::move(handler))
+{}
+
+template <typename M>
+execq::impl::Actor<M>::~Actor()
+{
+    m_isCanceled = true;
+    ActorScheduler(*m_actorSystem).waitIdle(*this);
+}
+
+// IActor
+
+template <typename M>
+void execq::impl::Actor<M>::sendImpl(M&& message)
+{
+    if (post(new ActorEnvelope<M>(std::move(message))))
+    {
+        ActorScheduler(*m_actorSystem).schedule(*this);
+    }
+}
+
+// ActorCore
+
+template <typename M>
+void execq::impl::Actor<M>::handle(MailboxNode* message)
+{
+    std::unique_ptr<ActorEnvelope<M>> envelope(static_cast<ActorEnvelope<M>*>(message));
+    m_handler(m_isCanceled, std::move(envelope->message));
+}
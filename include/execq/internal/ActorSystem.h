@@ -0,0 +1,130 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/IActor.h"
+#include "execq/internal/ExecutionPool.h"
+
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+namespace execq
+{
+    namespace impl
+    {
+        struct MailboxNode
+        {
+            std::atomic<MailboxNode*> next { nullptr };
+        };
+        
+        /**
+         * @brief Intrusive lock-free multi-producer single-consumer queue.
+         * @discussion 'pop' may return nullptr while a producer is in the middle of 'push'.
+         */
+        class Mailbox
+        {
+        public:
+            Mailbox();
+            
+            void push(MailboxNode* node);
+            MailboxNode* pop();
+            
+        private:
+            std::atomic<MailboxNode*> m_head;
+            MailboxNode* m_tail;
+            MailboxNode m_stub;
+        };
+        
+        class ActorCore
+        {
+        public:
+            virtual ~ActorCore() = default;
+            
+            /**
+             * @brief Processes up to 'messageBudget' messages.
+             * @return true if there are more messages to process.
+             */
+            bool activate(const size_t messageBudget);
+            bool isIdle() const;
+            
+        protected:
+            /**
+             * @brief Puts the message into the mailbox.
+             * @return true if the mailbox was empty, so the actor must be scheduled.
+             */
+            bool post(MailboxNode* message);
+            
+            /**
+             * @brief Processes and deletes the message.
+             */
+            virtual void handle(MailboxNode* message) = 0;
+            
+        private:
+            friend class ActorSystem;
+            
+            Mailbox m_mailbox;
+            std::atomic<size_t> m_pendingCount { 0 };
+            ActorCore* m_nextScheduled = nullptr;
+        };
+        
+        class ActorSystem: public IActorSystem, private IActorScheduler, private ITaskProvider
+        {
+        public:
+            ActorSystem(std::shared_ptr<IExecutionPool> executionPool,
+                        const IThreadWorkerFactory& workerFactory,
+                        const size_t messageBudget);
+            ~ActorSystem();
+            
+        private: // IActorSystem
+            virtual IActorScheduler& actorScheduler() final;
+            
+        private: // IActorScheduler
+            virtual void schedule(ActorCore& actor) final;
+            virtual void waitIdle(const ActorCore& actor) final;
+            
+        private: // ITaskProvider
+            virtual Task nextTask() final;
+            
+        private:
+            void enqueue(ActorCore& actor);
+            void notifyWorkers();
+            
+        private:
+            ActorCore* m_runQueueHead = nullptr;
+            ActorCore* m_runQueueTail = nullptr;
+            size_t m_activeCount = 0;
+            size_t m_idleWaitersCount = 0;
+            
+            std::mutex m_mutex;
+            std::condition_variable m_idleCondition;
+            
+            const size_t m_messageBudget;
+            const std::shared_ptr<IExecutionPool> m_executionPool;
+            
+            const std::unique_ptr<IThreadWorker> m_additionalWorker;
+        };
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/IAsyncSemaphore.h"
+#include "execq/internal/ExecutionPool.h"
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+namespace execq
+{
+    namespace impl
+    {
+        class AsyncSemaphore: public IAsyncSemaphore, private ITaskProvider
+        {
+        public:
+            using Continuation = std::function<void(const std::atomic_bool& isCanceled, AsyncPermit permit)>;
+            
+            AsyncSemaphore(const size_t permitCount,
+                           std::shared_ptr<IExecutionPool> executionPool,
+                           const IThreadWorkerFactory& workerFactory);
+            ~AsyncSemaphore();
+            
+        public: // IAsyncSemaphore
+            virtual void acquire(Continuation continuation) final;
+            virtual AsyncPermit tryAcquire() final;
+            
+        private: // IAsyncSemaphore
+            virtual void releasePermit() final;
+            
+        private: // ITaskProvider
+            virtual Task nextTask() final;
+            
+        private:
+            bool isIdle() const;
+            void notifyWorkers();
+            
+        private:
+            size_t m_availableCount;
+            std::deque<Continuation> m_waiting;
+            std::deque<Continuation> m_granted;
+            size_t m_runningCount = 0;
+            std::atomic_bool m_isCanceled { false };
+            
+            std::mutex m_mutex;
+            std::condition_variable m_idleCondition;
+            
+            const size_t m_permitCount;
+            const std::shared_ptr<IExecutionPool> m_executionPool;
+            
+            const std::unique_ptr<IThreadWorker> m_additionalWorker;
+        };
+    }
+}
@@ -0,0 +1,270 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/IBarrierExecutionQueue.h"
+#include "execq/internal/CancelTokenProvider.h"
+#include "execq/internal/ExecutionPool.h"
+
+#include <deque>
+#include <condition_variable>
+#include <stdexcept>
+
+namespace execq
+{
+    namespace impl
+    {
+        template <typename T, typename R>
+        struct BarrierObject
+        {
+            std::unique_ptr<T> object;
+            std::promise<R> promise;
+            CancelToken cancelToken;
+            bool exclusive;
+        };
+        
+        template <typename T, typename R>
+        class BarrierExecutionQueue: public IBarrierExecutionQueue<R(T)>, private ITaskProvider
+        {
+        public:
+            BarrierExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                  const IThreadWorkerFactory& workerFactory,
+                                  std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor);
+            ~BarrierExecutionQueue();
+            
+        public: // IBarrierExecutionQueue
+            virtual void cancel() final;
+            
+        private: // IBarrierExecutionQueue
+            virtual std::future<R> pushImpl(std::unique_ptr<T> object, const bool exclusive) final;
+            
+        private: // ITaskProvider
+            virtual Task nextTask() final;
+            
+        private:
+            void execute(BarrierObject<T, void>& object);
+            template <typename Y>
+            void execute(BarrierObject<T, Y>& object);
+            
+            bool canStartNext() const;
+            void notifyStartable();
+            bool notifyWorkers();
+            
+        private:
+            std::deque<std::unique_ptr<BarrierObject<T, R>>> m_queue;
+            size_t m_pendingExclusiveCount = 0;
+            size_t m_sharedRunningCount = 0;
+            bool m_isExclusiveRunning = false;
+            std::mutex m_mutex;
+            std::condition_variable m_idleCondition;
+            
+            CancelTokenProvider m_cancelTokenProvider;
+            
+            const std::shared_ptr<IExecutionPool> m_executionPool;
+            const std::function<R(const std::atomic_bool& isCanceled, T&& object)> m_executor;
+            
+            const std::unique_ptr<IThreadWorker> m_additionalWorker;
+        };
+    }
+}
+
+template <typename T, typename R>
+execq::impl::BarrierExecutionQueue<T, R>::BarrierExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                const IThreadWorkerFactory& workerFactory,
+                                                                std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor)
+: m_executionPool(executionPool)
+, m_executor(std::move(executor))
+, m_additionalWorker(workerFactory.createWorker(*this))
+{
+    if (!m_executionPool)
+    {
+        throw std::invalid_argument("Failed to create queue: execution pool is null.");
+    }
+    
+    m_executionPool->addProvider(*this);
+}
+
+template <typename T, typename R>
+execq::impl::BarrierExecutionQueue<T, R>::~BarrierExecutionQueue()
+{
+    m_cancelTokenProvider.cancel();
+    
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this] { return m_queue.empty() && !m_sharedRunningCount && !m_isExclusiveRunning; });
+    lock.unlock();
+    
+    m_executionPool->removeProvider(*this);
+}
+
+// IBarrierExecutionQueue
+
+template <typename T, typename R>
+void execq::impl::BarrierExecutionQueue<T, R>::cancel()
+{
+    m_cancelTokenProvider.cancelAndRenew();
+}
+
+template <typename T, typename R>
+std::future<R> execq::impl::BarrierExecutionQueue<T, R>::pushImpl(std::unique_ptr<T> object, const bool exclusive)
+{
+    std::promise<R> promise;
+    std::future<R> future = promise.get_future();
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    // Object that has to wait for others is started by the task that finishes last.
+    const bool canStart = exclusive
+    ? m_queue.empty() && !m_sharedRunningCount && !m_isExclusiveRunning
+    : !m_pendingExclusiveCount && !m_isExclusiveRunning;
+    
+    m_queue.emplace_back(new BarrierObject<T, R> { std::move(object), std::move(promise), m_cancelTokenProvider.token(), exclusive });
+    if (exclusive)
+    {
+        m_pendingExclusiveCount++;
+    }
+    
+    if (canStart)
+    {
+        notifyWorkers();
+    }
+    
+    return future;
+}
+
+// ITaskProvider
+
+template <typename T, typename R>
+execq::impl::Task execq::impl::BarrierExecutionQueue<T, R>::nextTask()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!canStartNext())
+    {
+        return Task();
+    }
+    
+    std::shared_ptr<BarrierObject<T, R>> object(std::move(m_queue.front()));
+    m_queue.pop_front();
+    
+    if (object->exclusive)
+    {
+        m_pendingExclusiveCount--;
+        m_isExclusiveRunning = true;
+    }
+    else
+    {
+        m_sharedRunningCount++;
+    }
+    
+    return Task([this, object] {
+        execute(*object);
+        
+        // Queue can't be destroyed until the task is completely finished.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (object->exclusive)
+        {
+            m_isExclusiveRunning = false;
+        }
+        else
+        {
+            m_sharedRunningCount--;
+        }
+        
+        if (m_queue.empty())
+        {
+            if (!m_sharedRunningCount && !m_isExclusiveRunning)
+            {
+                m_idleCondition.notify_all();
+            }
+        }
+        else if (object->exclusive || !m_sharedRunningCount)
+        {
+            // Objects held back by this one can start now.
+            notifyStartable();
+        }
+    });
+}
+
+// Private
+
+template <typename T, typename R>
+void execq::impl::BarrierExecutionQueue<T, R>::execute(BarrierObject<T, void>& object)
+{
+    m_executor(*object.cancelToken, std::move(*object.object));
+    object.promise.set_value();
+}
+
+template <typename T, typename R>
+template <typename Y>
+void execq::impl::BarrierExecutionQueue<T, R>::execute(BarrierObject<T, Y>& object)
+{
+    object.promise.set_value(m_executor(*object.cancelToken, std::move(*object.object)));
+}
+
+template <typename T, typename R>
+bool execq::impl::BarrierExecutionQueue<T, R>::canStartNext() const
+{
+    if (m_queue.empty() || m_isExclusiveRunning)
+    {
+        return false;
+    }
+    
+    return !m_queue.front()->exclusive || !m_sharedRunningCount;
+}
+
+template <typename T, typename R>
+void execq::impl::BarrierExecutionQueue<T, R>::notifyStartable()
+{
+    if (!canStartNext())
+    {
+        return;
+    }
+    
+    if (m_queue.front()->exclusive)
+    {
+        notifyWorkers();
+        return;
+    }
+    
+    // Wake a thread per shared object up to the next exclusive one, while there are free threads.
+    for (size_t i = 0; i < m_queue.size() && !m_queue[i]->exclusive; i++)
+    {
+        if (!notifyWorkers())
+        {
+            break;
+        }
+    }
+}
+
+template <typename T, typename R>
+bool execq::impl::BarrierExecutionQueue<T, R>::notifyWorkers()
+{
+    if (m_executionPool->notifyOneWorker())
+    {
+        return true;
+    }
+    
+    m_additionalWorker->notifyWorker();
+    return false;
+}
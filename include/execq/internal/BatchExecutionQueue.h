@@ -0,0 +1,306 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/IBatchExecutionQueue.h"
+#include "execq/internal/CancelTokenProvider.h"
+#include "execq/internal/ExecutionPool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+namespace execq
+{
+    namespace impl
+    {
+        template <typename T>
+        class BatchExecutionQueue: public IBatchExecutionQueue<T>, private ITaskProvider
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "BatchExecutionQueue supports only trivially copyable objects.");
+            
+        public:
+            BatchExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                const IThreadWorkerFactory& workerFactory,
+                                const size_t batchSize,
+                                std::function<void(const std::atomic_bool& isCanceled, ObjectBatch<T> batch)> executor);
+            ~BatchExecutionQueue();
+            
+        public: // IBatchExecutionQueue
+            virtual uint64_t push(const T& object) final;
+            virtual uint64_t push(const T* objects, const size_t count) final;
+            virtual void cancel() final;
+            
+        private: // ITaskProvider
+            virtual Task nextTask() final;
+            
+        private:
+            struct Chunk
+            {
+                std::unique_ptr<char[]> storage;
+                T* objects;
+                size_t count;
+                uint64_t firstIndex;
+                CancelToken cancelToken;
+            };
+            
+            std::unique_ptr<Chunk> makeChunk();
+            void sealCurrentChunk();
+            std::unique_ptr<Chunk> popChunk();
+            void recycleChunk(std::unique_ptr<Chunk> chunk);
+            
+            void notifyWorkers();
+            void waitAllTasks();
+            
+        private:
+            std::atomic_size_t m_taskRunningCount { 0 };
+            std::atomic_bool m_hasTask { false };
+            
+            std::unique_ptr<Chunk> m_currentChunk;
+            std::deque<std::unique_ptr<Chunk>> m_sealedChunks;
+            std::vector<std::unique_ptr<Chunk>> m_freeChunks;
+            uint64_t m_nextIndex = 0;
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            
+            CancelTokenProvider m_cancelTokenProvider;
+            
+            const size_t m_batchSize;
+            const std::shared_ptr<IExecutionPool> m_executionPool;
+            const std::function<void(const std::atomic_bool& isCanceled, ObjectBatch<T> batch)> m_executor;
+            
+            const std::unique_ptr<IThreadWorker> m_additionalWorker;
+        };
+    }
+}
+
+template <typename T>
+execq::impl::BatchExecutionQueue<T>::BatchExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                         const IThreadWorkerFactory& workerFactory,
+                                                         const size_t batchSize,
+                                                         std::function<void(const std::atomic_bool& isCanceled, ObjectBatch<T> batch)> executor)
+: m_batchSize(std::max<size_t>(batchSize, 1))
+, m_executionPool(executionPool)
+, m_executor(std::move(executor))
+, m_additionalWorker(workerFactory.createWorker(*this))
+{
+    if (!m_executionPool)
+    {
+        throw std::invalid_argument("Failed to create queue: execution pool is null.");
+    }
+    
+    m_executionPool->addProvider(*this);
+}
+
+template <typename T>
+execq::impl::BatchExecutionQueue<T>::~BatchExecutionQueue()
+{
+    m_cancelTokenProvider.cancel();
+    waitAllTasks();
+    m_executionPool->removeProvider(*this);
+}
+
+// IBatchExecutionQueue
+
+template <typename T>
+uint64_t execq::impl::BatchExecutionQueue<T>::push(const T& object)
+{
+    return push(&object, 1);
+}
+
+template <typename T>
+uint64_t execq::impl::BatchExecutionQueue<T>::push(const T* objects, const size_t count)
+{
+    size_t notificationCount = 0;
+    uint64_t firstIndex = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        firstIndex = m_nextIndex;
+        if (!m_hasTask)
+        {
+            notificationCount = 1;
+        }
+        
+        size_t sealedCount = 0;
+        for (size_t copied = 0; copied < count;)
+        {
+            if (!m_currentChunk)
+            {
+                m_currentChunk = makeChunk();
+            }
+            
+            const size_t chunkCount = std::min(count - copied, m_batchSize - m_currentChunk->count);
+            std::memcpy(m_currentChunk->objects + m_currentChunk->count, objects + copied, chunkCount * sizeof(T));
+            m_currentChunk->count += chunkCount;
+            m_nextIndex += chunkCount;
+            copied += chunkCount;
+            
+            if (m_currentChunk->count == m_batchSize)
+            {
+                sealCurrentChunk();
+                sealedCount++;
+            }
+        }
+        
+        m_hasTask = m_hasTask || count > 0;
+        notificationCount = std::max(notificationCount, sealedCount);
+    }
+    
+    // Full batches are notified one-by-one. Partial batch is picked up by the first free thread.
+    for (size_t i = 0; i < notificationCount; i++)
+    {
+        notifyWorkers();
+    }
+    
+    return firstIndex;
+}
+
+template <typename T>
+void execq::impl::BatchExecutionQueue<T>::cancel()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cancelTokenProvider.cancelAndRenew();
+    
+    // Objects pushed after 'cancel' must not get into the same batch with canceled ones.
+    sealCurrentChunk();
+}
+
+// ITaskProvider
+
+template <typename T>
+execq::impl::Task execq::impl::BatchExecutionQueue<T>::nextTask()
+{
+    if (!m_hasTask)
+    {
+        return Task();
+    }
+    
+    m_taskRunningCount++;
+    return Task([&] {
+        std::unique_ptr<Chunk> chunk = popChunk();
+        if (chunk)
+        {
+            m_executor(*chunk->cancelToken, ObjectBatch<T> { chunk->objects, chunk->count, chunk->firstIndex });
+            recycleChunk(std::move(chunk));
+        }
+        
+        // Queue can't be destroyed until the task is completely finished.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_taskRunningCount == 0 && !m_hasTask)
+        {
+            m_condition.notify_all();
+        }
+    });
+}
+
+// Private
+
+template <typename T>
+std::unique_ptr<typename execq::impl::BatchExecutionQueue<T>::Chunk> execq::impl::BatchExecutionQueue<T>::makeChunk()
+{
+    std::unique_ptr<Chunk> chunk;
+    if (!m_freeChunks.empty())
+    {
+        chunk = std::move(m_freeChunks.back());
+        m_freeChunks.pop_back();
+    }
+    else
+    {
+        chunk.reset(new Chunk());
+        
+        size_t space = m_batchSize * sizeof(T) + kBatchAlignment;
+        chunk->storage.reset(new char[space]);
+        
+        void* objects = chunk->storage.get();
+        std::align(kBatchAlignment, m_batchSize * sizeof(T), objects, space);
+        chunk->objects = static_cast<T*>(objects);
+    }
+    
+    chunk->count = 0;
+    chunk->firstIndex = m_nextIndex;
+    chunk->cancelToken = m_cancelTokenProvider.token();
+    
+    return chunk;
+}
+
+template <typename T>
+void execq::impl::BatchExecutionQueue<T>::sealCurrentChunk()
+{
+    if (m_currentChunk && m_currentChunk->count)
+    {
+        m_sealedChunks.push_back(std::move(m_currentChunk));
+    }
+}
+
+template <typename T>
+std::unique_ptr<typename execq::impl::BatchExecutionQueue<T>::Chunk> execq::impl::BatchExecutionQueue<T>::popChunk()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    // If there are no full batches, take the partial one instead of waiting for more objects.
+    sealCurrentChunk();
+    if (m_sealedChunks.empty())
+    {
+        return nullptr;
+    }
+    
+    std::unique_ptr<Chunk> chunk = std::move(m_sealedChunks.front());
+    m_sealedChunks.pop_front();
+    
+    m_hasTask = !m_sealedChunks.empty();
+    
+    return chunk;
+}
+
+template <typename T>
+void execq::impl::BatchExecutionQueue<T>::recycleChunk(std::unique_ptr<Chunk> chunk)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    chunk->cancelToken.reset();
+    m_freeChunks.push_back(std::move(chunk));
+}
+
+template <typename T>
+void execq::impl::BatchExecutionQueue<T>::notifyWorkers()
+{
+    if (!m_executionPool->notifyOneWorker())
+    {
+        m_additionalWorker->notifyWorker();
+    }
+}
+
+template <typename T>
+void execq::impl::BatchExecutionQueue<T>::waitAllTasks()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_taskRunningCount > 0 || m_hasTask)
+    {
+        m_condition.wait(lock);
+    }
+}
@@ -0,0 +1,145 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/Channel.h"
+#include "execq/internal/ExecutionPool.h"
+
+#include <stdexcept>
+
+namespace execq
+{
+    namespace impl
+    {
+        template <typename T>
+        class ChannelReceiver: public IChannelReceiver, private ITaskProvider, private IChannelListener
+        {
+        public:
+            ChannelReceiver(std::shared_ptr<IExecutionPool> executionPool,
+                            const IThreadWorkerFactory& workerFactory,
+                            std::shared_ptr<Channel<T>> channel,
+                            std::function<void(const std::atomic_bool& isCanceled, T&& value)> handler);
+            ~ChannelReceiver();
+            
+        private: // ITaskProvider
+            virtual Task nextTask() final;
+            
+        private: // IChannelListener
+            virtual void onChannelReady() final;
+            
+        private:
+            size_t m_runningCount = 0;
+            std::atomic_bool m_isCanceled { false };
+            std::mutex m_mutex;
+            std::condition_variable m_idleCondition;
+            
+            const std::shared_ptr<IExecutionPool> m_executionPool;
+            const std::shared_ptr<Channel<T>> m_channel;
+            const std::function<void(const std::atomic_bool& isCanceled, T&& value)> m_handler;
+            
+            const std::unique_ptr<IThreadWorker> m_additionalWorker;
+        };
+    }
+}
+
+template <typename T>
+execq::impl::ChannelReceiver<T>::ChannelReceiver(std::shared_ptr<IExecutionPool> executionPool,
+                                                 const IThreadWorkerFactory& workerFactory,
+                                                 std::shared_ptr<Channel<T>> channel,
+                                                 std::function<void(const std::atomic_bool& isCanceled, T&& value)> handler)
+: m_executionPool(executionPool)
+, m_channel(channel)
+, m_handler(std::move(handler))
+, m_additionalWorker(workerFactory.createWorker(*this))
+{
+    if (!m_executionPool)
+    {
+        throw std::invalid_argument("Failed to create channel receiver: execution pool is null.");
+    }
+    
+    m_executionPool->addProvider(*this);
+    m_channel->addListener(*this);
+    
+    // Values sent before the receiver has been created.
+    onChannelReady();
+}
+
+template <typename T>
+execq::impl::ChannelReceiver<T>::~ChannelReceiver()
+{
+    m_channel->removeListener(*this);
+    
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_isCanceled = true;
+    m_idleCondition.wait(lock, [this] { return !m_runningCount; });
+    lock.unlock();
+    
+    m_executionPool->removeProvider(*this);
+}
+
+// ITaskProvider
+
+template <typename T>
+execq::impl::Task execq::impl::ChannelReceiver<T>::nextTask()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_isCanceled)
+    {
+        return Task();
+    }
+    
+    // Value is taken right away: other receivers and 'receive' calls of the channel compete for it.
+    T received;
+    if (!m_channel->tryReceive(received))
+    {
+        return Task();
+    }
+    
+    m_runningCount++;
+    const std::shared_ptr<T> value = std::make_shared<T>(std::move(received));
+    
+    return Task([this, value] {
+        m_handler(m_isCanceled, std::move(*value));
+        
+        // Receiver can't be destroyed until the task is completely finished.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_runningCount--;
+        if (!m_runningCount)
+        {
+            m_idleCondition.notify_all();
+        }
+    });
+}
+
+// IChannelListener
+
+template <typename T>
+void execq::impl::ChannelReceiver<T>::onChannelReady()
+{
+    if (!m_executionPool->notifyOneWorker())
+    {
+        m_additionalWorker->notifyWorker();
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/internal/MoveOnlyFunction.h"
+#include "execq/internal/ThreadWorker.h"
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+namespace execq
+{
+    class IExecutionPool;
+    
+    namespace impl
+    {
+        /**
+         * @class ClosureQueue
+         * @brief Concurrent queue of ad-hoc closures shared by all 'Async'/'Post' calls on the pool.
+         * @discussion Created by the pool on first use, so the pool has single provider registration
+         * and single additional thread for all closures.
+         */
+        class ClosureQueue: private ITaskProvider
+        {
+        public:
+            ClosureQueue(IExecutionPool& executionPool, const IThreadWorkerFactory& workerFactory);
+            ~ClosureQueue();
+            
+            void post(Closure closure);
+            
+        private: // ITaskProvider
+            virtual Task nextTask() final;
+            
+        private:
+            void notifyWorkers();
+            
+        private:
+            std::deque<Closure> m_closures;
+            std::atomic_bool m_hasClosures { false };
+            size_t m_runningCount = 0;
+            
+            std::mutex m_mutex;
+            std::condition_variable m_idleCondition;
+            
+            IExecutionPool& m_executionPool;
+            const std::unique_ptr<IThreadWorker> m_additionalWorker;
+        };
+    }
+}
@@ -0,0 +1,249 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/ICoalescingExecutionQueue.h"
+#include "execq/internal/CancelTokenProvider.h"
+#include "execq/internal/ExecutionPool.h"
+
+#include <deque>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace execq
+{
+    namespace impl
+    {
+        template <typename K, typename T, typename R>
+        struct CoalescedObject
+        {
+            K key;
+            T object;
+            std::promise<R> promise;
+            std::shared_future<R> future;
+            CancelToken cancelToken;
+        };
+        
+        template <typename K, typename T, typename R>
+        class CoalescingExecutionQueue: public ICoalescingExecutionQueue<R(T)>, private ITaskProvider
+        {
+        public:
+            CoalescingExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                     const IThreadWorkerFactory& workerFactory,
+                                     std::function<K(const T& object)> keyExtractor,
+                                     std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                     std::function<void(T& pending, T&& object)> merge);
+            ~CoalescingExecutionQueue();
+            
+        public: // ICoalescingExecutionQueue
+            virtual void cancel() final;
+            
+        private: // ICoalescingExecutionQueue
+            virtual std::shared_future<R> pushImpl(T&& object) final;
+            
+        private: // IThreadWorkerPoolTaskProvider
+            virtual Task nextTask() final;
+            
+        private:
+            void execute(CoalescedObject<K, T, void>& object);
+            template <typename Y>
+            void execute(CoalescedObject<K, T, Y>& object);
+            
+            std::unique_ptr<CoalescedObject<K, T, R>> popObject();
+            void notifyWorkers();
+            
+        private:
+            std::atomic_size_t m_taskRunningCount { 0 };
+            
+            std::atomic_bool m_hasTask { false };
+            std::deque<std::unique_ptr<CoalescedObject<K, T, R>>> m_taskQueue;
+            std::unordered_map<K, CoalescedObject<K, T, R>*> m_pendingObjects;
+            std::mutex m_taskQueueMutex;
+            std::condition_variable m_taskQueueCondition;
+            
+            CancelTokenProvider m_cancelTokenProvider;
+            
+            const std::shared_ptr<IExecutionPool> m_executionPool;
+            const std::function<K(const T& object)> m_keyExtractor;
+            const std::function<R(const std::atomic_bool& isCanceled, T&& object)> m_executor;
+            const std::function<void(T& pending, T&& object)> m_merge;
+            
+            const std::unique_ptr<IThreadWorker> m_additionalWorker;
+        };
+    }
+}
+
+template <typename K, typename T, typename R>
+execq::impl::CoalescingExecutionQueue<K, T, R>::CoalescingExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                         const IThreadWorkerFactory& workerFactory,
+                                                                         std::function<K(const T& object)> keyExtractor,
+                                                                         std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                                                         std::function<void(T& pending, T&& object)> merge)
+: m_executionPool(executionPool)
+, m_keyExtractor(std::move(keyExtractor))
+, m_executor(std::move(executor))
+, m_merge(std::move(merge))
+, m_additionalWorker(workerFactory.createWorker(*this))
+{
+    if (!m_executionPool)
+    {
+        throw std::invalid_argument("Failed to create queue: execution pool is null.");
+    }
+    
+    m_executionPool->addProvider(*this);
+}
+
+template <typename K, typename T, typename R>
+execq::impl::CoalescingExecutionQueue<K, T, R>::~CoalescingExecutionQueue()
+{
+    m_cancelTokenProvider.cancel();
+    
+    std::unique_lock<std::mutex> lock(m_taskQueueMutex);
+    m_taskQueueCondition.wait(lock, [this] { return !m_hasTask && !m_taskRunningCount; });
+    lock.unlock();
+    
+    m_executionPool->removeProvider(*this);
+}
+
+// ICoalescingExecutionQueue
+
+template <typename K, typename T, typename R>
+void execq::impl::CoalescingExecutionQueue<K, T, R>::cancel()
+{
+    m_cancelTokenProvider.cancelAndRenew();
+}
+
+template <typename K, typename T, typename R>
+std::shared_future<R> execq::impl::CoalescingExecutionQueue<K, T, R>::pushImpl(T&& object)
+{
+    using CoalescedObject = CoalescedObject<K, T, R>;
+    
+    K key = m_keyExtractor(object);
+    
+    std::unique_lock<std::mutex> lock(m_taskQueueMutex);
+    
+    const auto pendingIt = m_pendingObjects.find(key);
+    if (pendingIt != m_pendingObjects.end())
+    {
+        CoalescedObject& pending = *pendingIt->second;
+        if (m_merge)
+        {
+            m_merge(pending.object, std::move(object));
+        }
+        else
+        {
+            pending.object = std::move(object);
+        }
+        
+        // Coalesced object is canceled only if the latest push is canceled.
+        pending.cancelToken = m_cancelTokenProvider.token();
+        
+        return pending.future;
+    }
+    
+    std::unique_ptr<CoalescedObject> coalescedObject(new CoalescedObject { key, std::move(object), std::promise<R>(), std::shared_future<R>(),
+                                                                           m_cancelTokenProvider.token() });
+    coalescedObject->future = coalescedObject->promise.get_future().share();
+    std::shared_future<R> future = coalescedObject->future;
+    
+    m_pendingObjects.emplace(std::move(key), coalescedObject.get());
+    m_taskQueue.push_back(std::move(coalescedObject));
+    m_hasTask = true;
+    
+    lock.unlock();
+    notifyWorkers();
+    
+    return future;
+}
+
+// IThreadWorkerPoolTaskProvider
+
+template <typename K, typename T, typename R>
+execq::impl::Task execq::impl::CoalescingExecutionQueue<K, T, R>::nextTask()
+{
+    if (!m_hasTask)
+    {
+        return Task();
+    }
+    
+    m_taskRunningCount++;
+    return Task([this] {
+        std::unique_ptr<CoalescedObject<K, T, R>> object = popObject();
+        if (object)
+        {
+            execute(*object);
+        }
+        
+        // Queue can't be destroyed until the task is completely finished.
+        std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+        if (--m_taskRunningCount == 0 && !m_hasTask)
+        {
+            m_taskQueueCondition.notify_all();
+        }
+    });
+}
+
+// Private
+
+template <typename K, typename T, typename R>
+void execq::impl::CoalescingExecutionQueue<K, T, R>::execute(CoalescedObject<K, T, void>& object)
+{
+    m_executor(*object.cancelToken, std::move(object.object));
+    object.promise.set_value();
+}
+
+template <typename K, typename T, typename R>
+template <typename Y>
+void execq::impl::CoalescingExecutionQueue<K, T, R>::execute(CoalescedObject<K, T, Y>& object)
+{
+    object.promise.set_value(m_executor(*object.cancelToken, std::move(object.object)));
+}
+
+template <typename K, typename T, typename R>
+std::unique_ptr<execq::impl::CoalescedObject<K, T, R>> execq::impl::CoalescingExecutionQueue<K, T, R>::popObject()
+{
+    std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+    if (m_taskQueue.empty())
+    {
+        return nullptr;
+    }
+    
+    std::unique_ptr<CoalescedObject<K, T, R>> object = std::move(m_taskQueue.front());
+    m_taskQueue.pop_front();
+    m_pendingObjects.erase(object->key);
+    
+    m_hasTask = !m_taskQueue.empty();
+    
+    return object;
+}
+
+template <typename K, typename T, typename R>
+void execq::impl::CoalescingExecutionQueue<K, T, R>::notifyWorkers()
+{
+    if (!m_executionPool->notifyOneWorker())
+    {
+        m_additionalWorker->notifyWorker();
+    }
+}
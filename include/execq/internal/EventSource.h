@@ -0,0 +1,72 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/IEventSource.h"
+#include "execq/internal/ExecutionPool.h"
+
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+namespace execq
+{
+    namespace impl
+    {
+        class EventSource: public IEventSource, private ITaskProvider
+        {
+        public:
+            EventSource(const EventMerge merge,
+                        std::shared_ptr<IExecutionPool> executionPool,
+                        const IThreadWorkerFactory& workerFactory,
+                        std::function<void(const std::atomic_bool& isCanceled, const uint64_t value)> handler);
+            ~EventSource();
+            
+        public: // IEventSource
+            virtual void signal(const uint64_t value) final;
+            
+        private: // ITaskProvider
+            virtual Task nextTask() final;
+            
+        private:
+            void notifyWorkers();
+            
+        private:
+            std::atomic<uint64_t> m_accumulator { 0 };
+            std::atomic_bool m_isRunning { false };
+            std::atomic_bool m_isCanceled { false };
+            
+            std::mutex m_mutex;
+            std::condition_variable m_idleCondition;
+            
+            const EventMerge m_merge;
+            const std::shared_ptr<IExecutionPool> m_executionPool;
+            const std::function<void(const std::atomic_bool& isCanceled, const uint64_t value)> m_handler;
+            
+            const std::unique_ptr<IThreadWorker> m_additionalWorker;
+        };
+    }
+}
@@ -25,9 +25,13 @@
 #pragma once
 
 #include "execq/internal/TaskProviderList.h"
+#include "execq/internal/Timer.h"
+#include "execq/internal/ClosureQueue.h"
 
 #include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace execq
@@ -42,6 +46,15 @@ namespace execq
         
         virtual bool notifyOneWorker() = 0;
         virtual void notifyAllWorkers() = 0;
+        
+        /**
+         * @brief Wakes up the worker preferred by 'affinity'.
+         * @discussion If all preferred workers are busy, other workers re-check spilling after the spill threshold.
+         */
+        virtual bool notifyOneWorker(const impl::TaskAffinity& affinity) = 0;
+        
+        virtual impl::Timer& timer() = 0;
+        virtual impl::ClosureQueue& closureQueue() = 0;
     };
     
     namespace impl
@@ -56,12 +69,42 @@ namespace execq
             
             virtual bool notifyOneWorker() final;
             virtual void notifyAllWorkers() final;
+            virtual bool notifyOneWorker(const TaskAffinity& affinity) final;
+            
+            virtual Timer& timer() final;
+            virtual ClosureQueue& closureQueue() final;
+            
+        private:
+            class WorkerSlot: public ITaskProvider
+            {
+            public:
+                WorkerSlot(ExecutionPool& pool, const size_t index);
+                
+                virtual Task nextTask() final;
+                
+            private:
+                ExecutionPool& m_pool;
+                const size_t m_index;
+            };
+            
+            Task nextTask(const size_t workerIndex);
+            bool isAllowedOnWorker(const ITaskProvider& provider, const size_t workerIndex) const;
+            void scheduleSpillCheck(const std::chrono::nanoseconds spillThreshold);
             
         private:
             std::atomic_bool m_valid { true };
+            std::atomic<int64_t> m_spillCheckDeadline { 0 };
             TaskProviderList m_providerGroup;
             
+            std::unique_ptr<std::atomic<int64_t>[]> m_workersBusySince;
+            std::vector<std::unique_ptr<WorkerSlot>> m_workerSlots;
             std::vector<std::unique_ptr<IThreadWorker>> m_workers;
+            
+            Timer m_timer;
+            
+            // Destroyed first: pending closures are executed while the workers are still alive.
+            std::unique_ptr<ClosureQueue> m_closureQueue;
+            std::once_flag m_closureQueueOnce;
         };
         
         
@@ -27,74 +27,207 @@
 #include "execq/IExecutionQueue.h"
 #include "execq/internal/CancelTokenProvider.h"
 #include "execq/internal/ExecutionPool.h"
+#include "execq/internal/MoveOnlyFunction.h"
+#include "execq/internal/RealtimeRing.h"
 
-#include <queue>
+#include <algorithm>
+#include <deque>
 
 namespace execq
 {
     namespace impl
     {
+        /**
+         * @discussion Result of the object is delivered either to the promise or to the completion queue,
+         * so only one of them is constructed. Object without both of them just drops the result.
+         */
         template <typename T, typename R>
         struct QueuedObject
         {
-            std::unique_ptr<T> object;
-            std::promise<R> promise;
+            using Promise = std::promise<R>;
+            using CompletionQueuePtr = std::shared_ptr<CompletionQueue<R>>;
+            
+            QueuedObject(ObjectPtr<T> object, CancelToken cancelToken, const size_t localityKey, Promise promise);
+            QueuedObject(ObjectPtr<T> object, CancelToken cancelToken, const size_t localityKey,
+                         CompletionQueuePtr completionQueue = nullptr, const uint64_t completionTag = 0);
+            ~QueuedObject();
+            
+            ObjectPtr<T> object;
             CancelToken cancelToken;
+            size_t localityKey;
+            const bool hasPromise;
+            union
+            {
+                Promise promise;
+                CompletionQueuePtr completionQueue;
+            };
+            uint64_t completionTag;
         };
         
         template <typename T, typename R>
-        class ExecutionQueue: public IExecutionQueue<R(T)>, private ITaskProvider
+        class ExecutionQueue: public IExecutionQueue<R(T)>, private ITaskProvider, private IExecutionTargetProtocol,
+                              private IExecutionTargetListener
         {
         public:
             ExecutionQueue(const bool serial, std::shared_ptr<IExecutionPool> executionPool,
                            const IThreadWorkerFactory& workerFactory,
-                           std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor);
+                           MoveOnlyFunction<R(const std::atomic_bool& isCanceled, T&& object)> executor);
             ~ExecutionQueue();
             
+            /**
+             * @brief Makes threads prefer pending objects with the same key as the object they have just processed.
+             * @discussion Objects with the same key are looked up among first 'window' pending objects.
+             * Single thread processes at most 'window' extra objects in a row this way.
+             * @discussion Has no effect for serial queues. Must be called before any object is pushed.
+             */
+            void setLocalityKey(std::function<size_t(const T& object)> keyExtractor, const size_t window);
+            
         public: // IExecutionQueue
             virtual void cancel() final;
+            virtual void setAffinity(const uint64_t threadMask, const std::chrono::milliseconds spillThreshold) final;
+            virtual void rebind(std::shared_ptr<IExecutionPool> executionPool) final;
+            virtual void setPrefetch(std::function<void(const T& object)> prefetch) final;
+            virtual void setTarget(IExecutionTarget& target) final;
+            virtual void reserveRealtime(const size_t capacity) final;
+            virtual bool tryPushRealtime(T&& object) final;
+            
+        private: // IExecutionTarget
+            virtual IExecutionTargetProtocol& targetProtocol() final;
+            
+        private: // IExecutionTargetProtocol
+            virtual bool tryEnter() final;
+            virtual void leave() final;
+            virtual void addListener(IExecutionTargetListener& listener) final;
+            virtual void removeListener(IExecutionTargetListener& listener) final;
+            virtual IExecutionTargetProtocol* parentTarget() const final;
             
         private: // IExecutionQueue
-            virtual std::future<R> pushImpl(std::unique_ptr<T> object) final;
+            virtual R dispatchSyncImpl(T& object) final;
+            virtual std::future<R> pushImpl(ObjectPtr<T> object) final;
+            virtual void pushImpl(ObjectPtr<T> object, std::shared_ptr<CompletionQueue<R>> completionQueue, const uint64_t tag) final;
             
         private: // IThreadWorkerPoolTaskProvider
             virtual Task nextTask() final;
+            virtual const TaskAffinity* affinity() const final;
+            
+        private: // IExecutionTargetListener
+            virtual bool onTargetAvailable() final;
             
         private:
-            void execute(T&& object, std::promise<void>& promise, const std::atomic_bool& canceled);
+            void execute(QueuedObject<T, void>& object);
             template <typename Y>
-            void execute(T&& object, std::promise<Y>& promise, const std::atomic_bool& canceled);
+            void execute(QueuedObject<T, Y>& object);
             
+            template <typename... Completion>
+            void enqueue(ObjectPtr<T> object, Completion&&... completion);
             void pushObject(std::unique_ptr<QueuedObject<T, R>> object, bool& alreadyHasTask);
             std::unique_ptr<QueuedObject<T, R>> popObject();
+            std::unique_ptr<QueuedObject<T, R>> popObjectWithKey(const size_t localityKey);
+            std::unique_ptr<QueuedObject<T, R>> popPrefetchedObject(const size_t localityKey, const size_t batched);
+            size_t takeRealtimeObjects();
             
+            std::shared_ptr<IExecutionPool> executionPool();
             void notifyWorkers();
             bool hasTask();
+            bool hasPendingObjects();
+            bool enterTask();
+            bool tryEnterLocked();
+            bool isExclusive() const;
+            void finishTask();
+            void finishTaskLocked();
+            bool notifyTargetListeners();
             void waitAllTasks();
             
         private:
+            static const size_t kMaxPrefetchBatch = 16;
+            
             std::atomic_size_t m_taskRunningCount { 0 };
             
             std::atomic_bool m_hasTask { false };
-            std::queue<std::unique_ptr<QueuedObject<T, R>>> m_taskQueue;
+            std::deque<std::unique_ptr<QueuedObject<T, R>>> m_taskQueue;
             std::mutex m_taskQueueMutex;
             std::condition_variable m_taskQueueCondition;
+            std::function<void(const T& object)> m_prefetch;
+            
+            std::unique_ptr<RealtimeRing<T>> m_realtimeRing;
+            std::atomic_bool m_hasRealtimeObjects { false };
             
             CancelTokenProvider m_cancelTokenProvider;
+            TaskAffinity m_affinity;
             
             const bool m_isSerial = false;
-            const std::shared_ptr<IExecutionPool> m_executionPool;
-            const std::function<R(const std::atomic_bool& isCanceled, T&& object)> m_executor;
+            std::shared_ptr<IExecutionPool> m_executionPool;
+            std::mutex m_executionPoolMutex;
+            std::mutex m_rebindMutex;
+            const MoveOnlyFunction<R(const std::atomic_bool& isCanceled, T&& object)> m_executor;
+            
+            std::function<size_t(const T& object)> m_localityKeyExtractor;
+            size_t m_localityWindow = 0;
+            
+            IExecutionTargetProtocol* m_target = nullptr;
+            std::atomic_bool m_hasTargetListeners { false };
+            std::vector<IExecutionTargetListener*> m_targetListeners;
+            size_t m_nextTargetListener = 0;
+            std::mutex m_targetListenersMutex;
             
             const std::unique_ptr<IThreadWorker> m_additionalWorker;
+            
+        private:
+            class InlineTaskGuard
+            {
+            public:
+                explicit InlineTaskGuard(ExecutionQueue& queue) : m_queue(queue) {}
+                ~InlineTaskGuard() { m_queue.finishTask(); }
+                
+            private:
+                ExecutionQueue& m_queue;
+            };
         };
     }
 }
 
+// QueuedObject
+
+template <typename T, typename R>
+execq::impl::QueuedObject<T, R>::QueuedObject(ObjectPtr<T> object, CancelToken cancelToken, const size_t localityKey, Promise promise)
+: object(std::move(object))
+, cancelToken(std::move(cancelToken))
+, localityKey(localityKey)
+, hasPromise(true)
+, promise(std::move(promise))
+, completionTag(0)
+{}
+
+template <typename T, typename R>
+execq::impl::QueuedObject<T, R>::QueuedObject(ObjectPtr<T> object, CancelToken cancelToken, const size_t localityKey,
+                                              CompletionQueuePtr completionQueue, const uint64_t completionTag)
+: object(std::move(object))
+, cancelToken(std::move(cancelToken))
+, localityKey(localityKey)
+, hasPromise(false)
+, completionQueue(std::move(completionQueue))
+, completionTag(completionTag)
+{}
+
+template <typename T, typename R>
+execq::impl::QueuedObject<T, R>::~QueuedObject()
+{
+    if (hasPromise)
+    {
+        promise.~Promise();
+    }
+    else
+    {
+        completionQueue.~CompletionQueuePtr();
+    }
+}
+
+// ExecutionQueue
+
 template <typename T, typename R>
 execq::impl::ExecutionQueue<T, R>::ExecutionQueue(const bool serial, std::shared_ptr<IExecutionPool> executionPool,
                                                   const IThreadWorkerFactory& workerFactory,
-                                                  std::function<R(const std::atomic_bool& shouldQuit, T&& object)> executor)
+                                                  MoveOnlyFunction<R(const std::atomic_bool& shouldQuit, T&& object)> executor)
 : m_isSerial(serial)
 , m_executionPool(executionPool)
 , m_executor(std::move(executor))
@@ -110,91 +243,381 @@ template <typename T, typename R>
 execq::impl::ExecutionQueue<T, R>::~ExecutionQueue()
 {
     m_cancelTokenProvider.cancel();
+    if (takeRealtimeObjects())
+    {
+        notifyWorkers();
+    }
+    
     waitAllTasks();
-    if (m_executionPool)
+    
+    if (m_target)
     {
-        m_executionPool->removeProvider(*this);
+        m_target->removeListener(*this);
     }
+    
+    const std::shared_ptr<IExecutionPool> pool = executionPool();
+    if (pool)
+    {
+        pool->removeProvider(*this);
+    }
+}
+
+template <typename T, typename R>
+void execq::impl::ExecutionQueue<T, R>::setLocalityKey(std::function<size_t(const T& object)> keyExtractor, const size_t window)
+{
+    if (m_isSerial)
+    {
+        return;
+    }
+    
+    m_localityKeyExtractor = std::move(keyExtractor);
+    m_localityWindow = m_localityKeyExtractor ? window : 0;
 }
 
 // IExecutionQueue
 
 template <typename T, typename R>
-std::future<R> execq::impl::ExecutionQueue<T, R>::pushImpl(std::unique_ptr<T> object)
+R execq::impl::ExecutionQueue<T, R>::dispatchSyncImpl(T& object)
 {
-    using QueuedObject = QueuedObject<T, R>;
+    // Objects accepted by 'tryPushRealtime' are ahead of this one, so the queue is not idle with them.
+    if (takeRealtimeObjects())
+    {
+        notifyWorkers();
+    }
+    
+    bool isIdle = false;
+    CancelToken cancelToken;
+    {
+        std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+        isIdle = m_taskQueue.empty() && !m_hasRealtimeObjects && tryEnterLocked();
+        cancelToken = m_cancelTokenProvider.token();
+    }
+    
+    if (isIdle)
+    {
+        // Caller's thread executes the object as if it were the queue's task.
+        InlineTaskGuard guard(*this);
+        const ExclusiveTaskGuard exclusiveGuard(isExclusive());
+        return m_executor(*cancelToken, std::move(object));
+    }
+    
+    std::future<R> future = pushImpl(ObjectPtr<T>(new UnownedObjectReleaser<T>(object)));
+    
+    // Pool thread doesn't just sleep: it executes other tasks until the result is ready.
+    // If there is nothing to execute, it waits: the object is guaranteed to be taken by the queue's additional worker.
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready && HelpCurrentWorker())
+    {}
     
+    return future.get();
+}
+
+template <typename T, typename R>
+std::future<R> execq::impl::ExecutionQueue<T, R>::pushImpl(ObjectPtr<T> object)
+{
     std::promise<R> promise;
     std::future<R> future = promise.get_future();
     
-    std::unique_ptr<QueuedObject> queuedObject(new QueuedObject { std::move(object), std::move(promise), m_cancelTokenProvider.token() });
-    
-    bool alreadyHasTask = false;
-    pushObject(std::move(queuedObject), alreadyHasTask);
+    enqueue(std::move(object), std::move(promise));
     
-    const bool shouldNotify = !m_isSerial || !alreadyHasTask;
-    if (shouldNotify)
+    return future;
+}
+
+template <typename T, typename R>
+void execq::impl::ExecutionQueue<T, R>::pushImpl(ObjectPtr<T> object, std::shared_ptr<CompletionQueue<R>> completionQueue, const uint64_t tag)
+{
+    if (!completionQueue)
     {
-        notifyWorkers();
+        throw std::invalid_argument("Failed to push object: completion queue is null.");
     }
     
-    return future;
+    enqueue(std::move(object), std::move(completionQueue), tag);
 }
 
 template <typename T, typename R>
 void execq::impl::ExecutionQueue<T, R>::cancel()
 {
+    // Objects waiting in the realtime slots have been pushed before 'cancel' as well.
+    if (takeRealtimeObjects())
+    {
+        notifyWorkers();
+    }
+    
     m_cancelTokenProvider.cancelAndRenew();
 }
 
+template <typename T, typename R>
+void execq::impl::ExecutionQueue<T, R>::setAffinity(const uint64_t threadMask, const std::chrono::milliseconds spillThreshold)
+{
+    m_affinity.set(threadMask, spillThreshold);
+}
+
+template <typename T, typename R>
+void execq::impl::ExecutionQueue<T, R>::rebind(std::shared_ptr<IExecutionPool> newPool)
+{
+    std::lock_guard<std::mutex> lock(m_rebindMutex);
+    
+    const std::shared_ptr<IExecutionPool> oldPool = executionPool();
+    if (oldPool == newPool)
+    {
+        return;
+    }
+    
+    // Queue itself keeps order and serial guarantees, so it is safe to be registered in both pools for a while.
+    if (newPool)
+    {
+        newPool->addProvider(*this);
+    }
+    
+    {
+        std::lock_guard<std::mutex> poolLock(m_executionPoolMutex);
+        m_executionPool = newPool;
+    }
+    
+    if (oldPool)
+    {
+        oldPool->removeProvider(*this);
+    }
+    
+    if (hasPendingObjects())
+    {
+        notifyWorkers();
+    }
+}
+
+template <typename T, typename R>
+void execq::impl::ExecutionQueue<T, R>::setPrefetch(std::function<void(const T& object)> prefetch)
+{
+    // Read by the tasks without the lock: the hook is set before any object is pushed.
+    m_prefetch = std::move(prefetch);
+}
+
+template <typename T, typename R>
+void execq::impl::ExecutionQueue<T, R>::setTarget(IExecutionTarget& target)
+{
+    IExecutionTargetProtocol& targetProtocol = TargetProtocol(target);
+    
+    // Queue in a cycle would wait for itself while it enters the targets.
+    for (const IExecutionTargetProtocol* parent = &targetProtocol; parent; parent = parent->parentTarget())
+    {
+        if (parent == this)
+        {
+            throw std::invalid_argument("Failed to set target: queue can't target itself, directly or through other queues.");
+        }
+    }
+    
+    if (m_target)
+    {
+        m_target->removeListener(*this);
+    }
+    
+    m_target = &targetProtocol;
+    m_target->addListener(*this);
+}
+
+template <typename T, typename R>
+void execq::impl::ExecutionQueue<T, R>::reserveRealtime(const size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+    if (m_realtimeRing)
+    {
+        throw std::logic_error("Failed to reserve realtime slots: slots are already reserved.");
+    }
+    
+    m_realtimeRing.reset(new RealtimeRing<T>(capacity));
+    m_additionalWorker->enableSignals();
+}
+
+template <typename T, typename R>
+bool execq::impl::ExecutionQueue<T, R>::tryPushRealtime(T&& object)
+{
+    if (!m_realtimeRing || !m_realtimeRing->tryPush(std::move(object)))
+    {
+        return false;
+    }
+    
+    // Only the object that makes the ring non-empty wakes up the queue's thread. No locks are taken on the way.
+    if (!m_hasRealtimeObjects.exchange(true))
+    {
+        m_additionalWorker->signalWorker();
+    }
+    
+    return true;
+}
+
+// IExecutionTarget
+
+template <typename T, typename R>
+execq::impl::IExecutionTargetProtocol& execq::impl::ExecutionQueue<T, R>::targetProtocol()
+{
+    return *this;
+}
+
+// IExecutionTargetProtocol
+
+template <typename T, typename R>
+bool execq::impl::ExecutionQueue<T, R>::tryEnter()
+{
+    std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+    return tryEnterLocked();
+}
+
+template <typename T, typename R>
+void execq::impl::ExecutionQueue<T, R>::leave()
+{
+    finishTask();
+}
+
+template <typename T, typename R>
+void execq::impl::ExecutionQueue<T, R>::addListener(IExecutionTargetListener& listener)
+{
+    std::lock_guard<std::mutex> lock(m_targetListenersMutex);
+    m_targetListeners.push_back(&listener);
+    m_hasTargetListeners = true;
+}
+
+template <typename T, typename R>
+void execq::impl::ExecutionQueue<T, R>::removeListener(IExecutionTargetListener& listener)
+{
+    std::lock_guard<std::mutex> lock(m_targetListenersMutex);
+    m_targetListeners.erase(std::remove(m_targetListeners.begin(), m_targetListeners.end(), &listener), m_targetListeners.end());
+}
+
+template <typename T, typename R>
+execq::impl::IExecutionTargetProtocol* execq::impl::ExecutionQueue<T, R>::parentTarget() const
+{
+    return m_target;
+}
+
 // IThreadWorkerPoolTaskProvider
 
 template <typename T, typename R>
 execq::impl::Task execq::impl::ExecutionQueue<T, R>::nextTask()
 {
-    if (!hasTask())
+    if (!hasTask() || !enterTask())
     {
         return Task();
     }
     
-    m_taskRunningCount++;
     return Task([&] {
-        std::unique_ptr<QueuedObject<T, R>> object = popObject();
-        if (object)
-        {
-            execute(std::move(*object->object), object->promise, *object->cancelToken);
-        }
+        const ExclusiveTaskGuard exclusiveGuard(isExclusive());
         
-        if (--m_taskRunningCount > 0)
+        // Objects taken from the realtime slots have not been announced to other threads yet.
+        const size_t realtimeObjectCount = takeRealtimeObjects();
+        for (size_t i = 1; i < realtimeObjectCount && !m_isSerial; i++)
         {
-            return;
+            notifyWorkers();
         }
         
-        if (!m_hasTask)
-        {
-            m_taskQueueCondition.notify_all();
-        }
-        else if (m_isSerial) // if there are more tasks and queue is serial, notify workers
+        std::unique_ptr<QueuedObject<T, R>> object = popObject();
+        for (size_t batched = 0; object; batched++)
         {
-            notifyWorkers();
+            std::unique_ptr<QueuedObject<T, R>> next;
+            if (m_prefetch)
+            {
+                // Next object is taken before the current one is executed and stays on this thread,
+                // so the hook warms the cache of the core that processes it. Called without the lock.
+                next = popPrefetchedObject(object->localityKey, batched);
+                if (next)
+                {
+                    m_prefetch(*next->object);
+                }
+            }
+            
+            execute(*object);
+            
+            if (!m_prefetch)
+            {
+                // With the warm cache, pick up the objects with the same key (if any) on the same thread.
+                next = batched < m_localityWindow ? popObjectWithKey(object->localityKey) : nullptr;
+            }
+            
+            object = std::move(next);
         }
+        
+        finishTask();
     });
 }
 
+template <typename T, typename R>
+const execq::impl::TaskAffinity* execq::impl::ExecutionQueue<T, R>::affinity() const
+{
+    return &m_affinity;
+}
+
+// IExecutionTargetListener
+
+template <typename T, typename R>
+bool execq::impl::ExecutionQueue<T, R>::onTargetAvailable()
+{
+    if (hasPendingObjects())
+    {
+        notifyWorkers();
+        return true;
+    }
+    
+    // Queues targeting this one may be waiting for the same target.
+    return m_hasTargetListeners && notifyTargetListeners();
+}
+
 // Private
 
 template <typename T, typename R>
-void execq::impl::ExecutionQueue<T, R>::execute(T&& object, std::promise<void>& promise, const std::atomic_bool& canceled)
+void execq::impl::ExecutionQueue<T, R>::execute(QueuedObject<T, void>& object)
 {
-    m_executor(canceled, std::move(object));
-    promise.set_value();
+    m_executor(*object.cancelToken, std::move(*object.object));
+    
+    if (object.hasPromise)
+    {
+        object.promise.set_value();
+    }
+    else if (object.completionQueue)
+    {
+        object.completionQueue->post(object.completionTag);
+    }
 }
 
 template <typename T, typename R>
 template <typename Y>
-void execq::impl::ExecutionQueue<T, R>::execute(T&& object, std::promise<Y>& promise, const std::atomic_bool& canceled)
+void execq::impl::ExecutionQueue<T, R>::execute(QueuedObject<T, Y>& object)
 {
-    promise.set_value(m_executor(canceled, std::move(object)));
+    if (object.hasPromise)
+    {
+        object.promise.set_value(m_executor(*object.cancelToken, std::move(*object.object)));
+    }
+    else if (object.completionQueue)
+    {
+        object.completionQueue->post(object.completionTag, m_executor(*object.cancelToken, std::move(*object.object)));
+    }
+    else
+    {
+        m_executor(*object.cancelToken, std::move(*object.object));
+    }
+}
+
+template <typename T, typename R>
+template <typename... Completion>
+void execq::impl::ExecutionQueue<T, R>::enqueue(ObjectPtr<T> object, Completion&&... completion)
+{
+    using QueuedObject = QueuedObject<T, R>;
+    
+    // Objects accepted by 'tryPushRealtime' before this one are queued first.
+    if (takeRealtimeObjects())
+    {
+        notifyWorkers();
+    }
+    
+    const size_t localityKey = m_localityKeyExtractor ? m_localityKeyExtractor(*object) : 0;
+    std::unique_ptr<QueuedObject> queuedObject(new QueuedObject(std::move(object), m_cancelTokenProvider.token(), localityKey,
+                                                                std::forward<Completion>(completion)...));
+    
+    bool alreadyHasTask = false;
+    pushObject(std::move(queuedObject), alreadyHasTask);
+    
+    const bool shouldNotify = !m_isSerial || !alreadyHasTask;
+    if (shouldNotify)
+    {
+        notifyWorkers();
+    }
 }
 
 template <typename T, typename R>
@@ -204,7 +627,7 @@ void execq::impl::ExecutionQueue<T, R>::pushObject(std::unique_ptr<QueuedObject<
     
     alreadyHasTask = m_hasTask;
     m_hasTask = true;
-    m_taskQueue.push(std::move(object));
+    m_taskQueue.push_back(std::move(object));
 }
 
 template <typename T, typename R>
@@ -217,17 +640,89 @@ std::unique_ptr<execq::impl::QueuedObject<T, R>> execq::impl::ExecutionQueue<T,
     }
     
     std::unique_ptr<QueuedObject<T, R>> object = std::move(m_taskQueue.front());
-    m_taskQueue.pop();
+    m_taskQueue.pop_front();
     
     m_hasTask = !m_taskQueue.empty();
     
     return object;
 }
 
+template <typename T, typename R>
+std::unique_ptr<execq::impl::QueuedObject<T, R>> execq::impl::ExecutionQueue<T, R>::popObjectWithKey(const size_t localityKey)
+{
+    std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+    
+    const size_t window = std::min(m_localityWindow, m_taskQueue.size());
+    for (size_t i = 0; i < window; i++)
+    {
+        if (m_taskQueue[i]->localityKey != localityKey)
+        {
+            continue;
+        }
+        
+        std::unique_ptr<QueuedObject<T, R>> object = std::move(m_taskQueue[i]);
+        m_taskQueue.erase(m_taskQueue.begin() + i);
+        
+        m_hasTask = !m_taskQueue.empty();
+        
+        return object;
+    }
+    
+    return nullptr;
+}
+
+template <typename T, typename R>
+size_t execq::impl::ExecutionQueue<T, R>::takeRealtimeObjects()
+{
+    if (!m_hasRealtimeObjects)
+    {
+        return 0;
+    }
+    
+    using QueuedObject = QueuedObject<T, R>;
+    
+    std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+    
+    // Cleared before taking: object pushed after that raises the flag and wakes up the queue's thread again.
+    m_hasRealtimeObjects = false;
+    
+    const CancelToken cancelToken = m_cancelTokenProvider.token();
+    size_t count = 0;
+    while (std::unique_ptr<T> object = m_realtimeRing->tryPop())
+    {
+        const size_t localityKey = m_localityKeyExtractor ? m_localityKeyExtractor(*object) : 0;
+        m_taskQueue.push_back(std::unique_ptr<QueuedObject>(new QueuedObject(std::move(object), cancelToken, localityKey)));
+        count++;
+    }
+    
+    if (count)
+    {
+        m_hasTask = true;
+    }
+    
+    return count;
+}
+
+template <typename T, typename R>
+std::unique_ptr<execq::impl::QueuedObject<T, R>> execq::impl::ExecutionQueue<T, R>::popPrefetchedObject(const size_t localityKey, const size_t batched)
+{
+    if (batched < m_localityWindow)
+    {
+        std::unique_ptr<QueuedObject<T, R>> object = popObjectWithKey(localityKey);
+        if (object)
+        {
+            return object;
+        }
+    }
+    
+    // Single task doesn't hold the pool thread forever: the rest of objects are left for the next tasks.
+    return batched + 1 < kMaxPrefetchBatch ? popObject() : nullptr;
+}
+
 template <typename T, typename R>
 bool execq::impl::ExecutionQueue<T, R>::hasTask()
 {
-    if (!m_hasTask)
+    if (!hasPendingObjects())
     {
         return false;
     }
@@ -240,10 +735,146 @@ bool execq::impl::ExecutionQueue<T, R>::hasTask()
     return !m_taskRunningCount;
 }
 
+template <typename T, typename R>
+bool execq::impl::ExecutionQueue<T, R>::hasPendingObjects()
+{
+    return m_hasTask || m_hasRealtimeObjects;
+}
+
+template <typename T, typename R>
+bool execq::impl::ExecutionQueue<T, R>::enterTask()
+{
+    if (!m_target && !m_hasTargetListeners)
+    {
+        if (!m_isSerial)
+        {
+            m_taskRunningCount++;
+            return true;
+        }
+        
+        // Serial queue may be asked for the task by the pool and the additional worker at the same time.
+        size_t idleCount = 0;
+        return m_taskRunningCount.compare_exchange_strong(idleCount, 1);
+    }
+    
+    // Tasks of the queue compete with the tasks of targeting queues, so the check and the increment must be atomic.
+    std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+    return tryEnterLocked();
+}
+
+template <typename T, typename R>
+bool execq::impl::ExecutionQueue<T, R>::tryEnterLocked()
+{
+    // Compared-and-exchanged: tasks of the queue without target are started without the lock.
+    size_t idleCount = 0;
+    if (!m_isSerial)
+    {
+        m_taskRunningCount++;
+    }
+    else if (!m_taskRunningCount.compare_exchange_strong(idleCount, 1))
+    {
+        return false;
+    }
+    
+    // Tasks of the queue with target are started under the lock, so nobody sees the count taken back.
+    if (m_target && !m_target->tryEnter())
+    {
+        m_taskRunningCount--;
+        return false;
+    }
+    
+    return true;
+}
+
+template <typename T, typename R>
+bool execq::impl::ExecutionQueue<T, R>::isExclusive() const
+{
+    // Task of serial queue or queue with target holds the slot other tasks may wait for.
+    return m_isSerial || m_target;
+}
+
+template <typename T, typename R>
+void execq::impl::ExecutionQueue<T, R>::finishTask()
+{
+    // Target is left first: queue can't be destroyed until the task is completely finished.
+    if (m_target)
+    {
+        m_target->leave();
+    }
+    
+    std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+    finishTaskLocked();
+}
+
+template <typename T, typename R>
+void execq::impl::ExecutionQueue<T, R>::finishTaskLocked()
+{
+    if (--m_taskRunningCount > 0)
+    {
+        return;
+    }
+    
+    if (!m_hasTask)
+    {
+        m_taskQueueCondition.notify_all();
+    }
+    
+    if (!m_isSerial)
+    {
+        return;
+    }
+    
+    if (m_hasTargetListeners)
+    {
+        // Serial target is free: give the turn to the next of itself and targeting queues.
+        notifyTargetListeners();
+    }
+    else if (hasPendingObjects()) // if there are more tasks and queue is serial, notify workers
+    {
+        notifyWorkers();
+    }
+}
+
+template <typename T, typename R>
+bool execq::impl::ExecutionQueue<T, R>::notifyTargetListeners()
+{
+    std::lock_guard<std::mutex> lock(m_targetListenersMutex);
+    
+    // The queue itself takes the last place in the turn.
+    const size_t participantCount = m_targetListeners.size() + 1;
+    for (size_t i = 0; i < participantCount; i++)
+    {
+        const size_t participant = m_nextTargetListener++ % participantCount;
+        if (participant < m_targetListeners.size())
+        {
+            if (m_targetListeners[participant]->onTargetAvailable())
+            {
+                return true;
+            }
+        }
+        else if (hasPendingObjects())
+        {
+            notifyWorkers();
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+template <typename T, typename R>
+std::shared_ptr<execq::IExecutionPool> execq::impl::ExecutionQueue<T, R>::executionPool()
+{
+    std::lock_guard<std::mutex> lock(m_executionPoolMutex);
+    return m_executionPool;
+}
+
 template <typename T, typename R>
 void execq::impl::ExecutionQueue<T, R>::notifyWorkers()
 {
-    if (!m_executionPool || !m_executionPool->notifyOneWorker())
+    // Pool is notified under the lock, so after rebinding the old pool is never referenced by the queue.
+    std::lock_guard<std::mutex> lock(m_executionPoolMutex);
+    if (!m_executionPool || !(m_affinity.isRestricted() ? m_executionPool->notifyOneWorker(m_affinity) : m_executionPool->notifyOneWorker()))
     {
         m_additionalWorker->notifyWorker();
     }
@@ -253,7 +884,7 @@ template <typename T, typename R>
 void execq::impl::ExecutionQueue<T, R>::waitAllTasks()
 {
     std::unique_lock<std::mutex> lock(m_taskQueueMutex);
-    while (m_taskRunningCount > 0 || !m_taskQueue.empty())
+    while (m_taskRunningCount > 0 || !m_taskQueue.empty() || m_hasRealtimeObjects)
     {
         m_taskQueueCondition.wait(lock);
     }
@@ -26,6 +26,7 @@
 
 #include "execq/IExecutionStream.h"
 #include "execq/internal/ExecutionPool.h"
+#include "execq/internal/MoveOnlyFunction.h"
 
 #include <mutex>
 #include <thread>
@@ -41,28 +42,31 @@ namespace execq
         public:
             ExecutionStream(std::shared_ptr<IExecutionPool> executionPool,
                             const IThreadWorkerFactory& workerFactory,
-                            std::function<void(const std::atomic_bool& isCanceled)> executee);
+                            MoveOnlyFunction<void(const std::atomic_bool& isCanceled)> executee);
             ~ExecutionStream();
             
         public: // IExecutionStream
             virtual void start() final;
             virtual void stop() final;
+            virtual void setAffinity(const uint64_t threadMask, const std::chrono::milliseconds spillThreshold) final;
             
         private: // ITaskProvider
             virtual Task nextTask() final;
+            virtual const TaskAffinity* affinity() const final;
             
         private:
             void waitPendingTasks();
             
         private:
             std::atomic_bool m_stopped { true };
+            TaskAffinity m_affinity;
             
             std::atomic_size_t m_tasksRunningCount { 0 };
             std::mutex m_taskCompleteMutex;
             std::condition_variable m_taskCompleteCondition;
             
             const std::shared_ptr<IExecutionPool> m_executionPool;
-            const std::function<void(const std::atomic_bool& shouldQuit)> m_executee;
+            const MoveOnlyFunction<void(const std::atomic_bool& shouldQuit)> m_executee;
             
             const std::unique_ptr<IThreadWorker> m_additionalWorker;
         };
@@ -0,0 +1,251 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/IMemoizingExecutionQueue.h"
+#include "execq/internal/ExecutionQueue.h"
+
+#include <list>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace execq
+{
+    namespace impl
+    {
+        template <typename K, typename T, typename R>
+        struct MemoizedObject
+        {
+            K key;
+            T object;
+            std::promise<R> promise;
+        };
+        
+        template <typename K, typename T, typename R>
+        class MemoizingExecutionQueue: public IMemoizingExecutionQueue<R(T)>
+        {
+        public:
+            MemoizingExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                    const IThreadWorkerFactory& workerFactory,
+                                    std::function<K(const T& object)> keyExtractor,
+                                    std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                    const size_t cacheCapacity,
+                                    const std::chrono::milliseconds cacheTtl);
+            ~MemoizingExecutionQueue();
+            
+        public: // IMemoizingExecutionQueue
+            virtual void cancel() final;
+            virtual void clearCache() final;
+            
+        private: // IMemoizingExecutionQueue
+            virtual std::shared_future<R> pushImpl(T&& object) final;
+            
+        private:
+            struct Entry
+            {
+                std::shared_future<R> future;
+                bool completed;
+                std::chrono::steady_clock::time_point completedAt;
+                typename std::list<K>::iterator lruPosition;
+            };
+            
+        private:
+            void execute(const std::atomic_bool& isCanceled, MemoizedObject<K, T, R>&& object);
+            void execute(const std::atomic_bool& isCanceled, MemoizedObject<K, T, R>& object, std::true_type /*voidResult*/);
+            void execute(const std::atomic_bool& isCanceled, MemoizedObject<K, T, R>& object, std::false_type /*voidResult*/);
+            void complete(const K& key, const bool succeeded);
+            bool isExpired(const Entry& entry) const;
+            
+        private:
+            std::unordered_map<K, Entry> m_entries;
+            std::list<K> m_lru;
+            std::mutex m_mutex;
+            
+            const size_t m_cacheCapacity = 0;
+            const std::chrono::milliseconds m_cacheTtl;
+            const std::function<K(const T& object)> m_keyExtractor;
+            const std::function<R(const std::atomic_bool& isCanceled, T&& object)> m_executor;
+            
+            std::unique_ptr<ExecutionQueue<MemoizedObject<K, T, R>, void>> m_queue;
+        };
+    }
+}
+
+template <typename K, typename T, typename R>
+execq::impl::MemoizingExecutionQueue<K, T, R>::MemoizingExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                       const IThreadWorkerFactory& workerFactory,
+                                                                       std::function<K(const T& object)> keyExtractor,
+                                                                       std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                                                       const size_t cacheCapacity,
+                                                                       const std::chrono::milliseconds cacheTtl)
+: m_cacheCapacity(cacheCapacity)
+, m_cacheTtl(cacheTtl)
+, m_keyExtractor(std::move(keyExtractor))
+, m_executor(std::move(executor))
+, m_queue(new ExecutionQueue<MemoizedObject<K, T, R>, void>(false, executionPool, workerFactory,
+                                                            [this] (const std::atomic_bool& isCanceled, MemoizedObject<K, T, R>&& object) {
+                                                                execute(isCanceled, std::move(object));
+                                                            }))
+{
+    if (!executionPool)
+    {
+        throw std::invalid_argument("Failed to create queue: execution pool is null.");
+    }
+}
+
+template <typename K, typename T, typename R>
+execq::impl::MemoizingExecutionQueue<K, T, R>::~MemoizingExecutionQueue()
+{
+    // Waits until all objects are processed.
+    m_queue.reset();
+}
+
+// IMemoizingExecutionQueue
+
+template <typename K, typename T, typename R>
+void execq::impl::MemoizingExecutionQueue<K, T, R>::cancel()
+{
+    m_queue->cancel();
+}
+
+template <typename K, typename T, typename R>
+void execq::impl::MemoizingExecutionQueue<K, T, R>::clearCache()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const K& key : m_lru)
+    {
+        m_entries.erase(key);
+    }
+    m_lru.clear();
+}
+
+template <typename K, typename T, typename R>
+std::shared_future<R> execq::impl::MemoizingExecutionQueue<K, T, R>::pushImpl(T&& object)
+{
+    K key = m_keyExtractor(object);
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    const auto entryIt = m_entries.find(key);
+    if (entryIt != m_entries.end())
+    {
+        Entry& entry = entryIt->second;
+        if (!entry.completed)
+        {
+            return entry.future;
+        }
+        
+        if (!isExpired(entry))
+        {
+            m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+            return entry.future;
+        }
+        
+        m_lru.erase(entry.lruPosition);
+        m_entries.erase(entryIt);
+    }
+    
+    // Pushed under the lock, so concurrent pushes of the same key never start second execution.
+    std::promise<R> promise;
+    std::shared_future<R> future = promise.get_future().share();
+    m_queue->push(MemoizedObject<K, T, R> { key, std::move(object), std::move(promise) });
+    m_entries.emplace(std::move(key), Entry { future, false, std::chrono::steady_clock::time_point(), m_lru.end() });
+    
+    return future;
+}
+
+// Private
+
+template <typename K, typename T, typename R>
+void execq::impl::MemoizingExecutionQueue<K, T, R>::execute(const std::atomic_bool& isCanceled, MemoizedObject<K, T, R>&& object)
+{
+    try
+    {
+        execute(isCanceled, object, std::is_void<R>());
+    }
+    catch (...)
+    {
+        // Failed result is not cached: next push of the key executes the object again.
+        complete(object.key, false);
+        object.promise.set_exception(std::current_exception());
+    }
+}
+
+template <typename K, typename T, typename R>
+void execq::impl::MemoizingExecutionQueue<K, T, R>::execute(const std::atomic_bool& isCanceled, MemoizedObject<K, T, R>& object,
+                                                            std::true_type /*voidResult*/)
+{
+    m_executor(isCanceled, std::move(object.object));
+    
+    // Result is cached right before it is passed to the future: pushes in between get the future that is about to be ready.
+    complete(object.key, !isCanceled);
+    object.promise.set_value();
+}
+
+template <typename K, typename T, typename R>
+void execq::impl::MemoizingExecutionQueue<K, T, R>::execute(const std::atomic_bool& isCanceled, MemoizedObject<K, T, R>& object,
+                                                            std::false_type /*voidResult*/)
+{
+    R result = m_executor(isCanceled, std::move(object.object));
+    
+    // Result is cached right before it is passed to the future: pushes in between get the future that is about to be ready.
+    complete(object.key, !isCanceled);
+    object.promise.set_value(std::move(result));
+}
+
+template <typename K, typename T, typename R>
+void execq::impl::MemoizingExecutionQueue<K, T, R>::complete(const K& key, const bool succeeded)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    const auto entryIt = m_entries.find(key);
+    if (entryIt == m_entries.end() || entryIt->second.completed)
+    {
+        return;
+    }
+    
+    if (!succeeded || !m_cacheCapacity)
+    {
+        m_entries.erase(entryIt);
+        return;
+    }
+    
+    Entry& entry = entryIt->second;
+    entry.completed = true;
+    entry.completedAt = std::chrono::steady_clock::now();
+    entry.lruPosition = m_lru.insert(m_lru.begin(), key);
+    
+    while (m_lru.size() > m_cacheCapacity)
+    {
+        m_entries.erase(m_lru.back());
+        m_lru.pop_back();
+    }
+}
+
+template <typename K, typename T, typename R>
+bool execq::impl::MemoizingExecutionQueue<K, T, R>::isExpired(const Entry& entry) const
+{
+    return m_cacheTtl != std::chrono::milliseconds::zero() && std::chrono::steady_clock::now() - entry.completedAt >= m_cacheTtl;
+}
@@ -0,0 +1,207 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+namespace execq
+{
+    namespace impl
+    {
+        template <typename Signature>
+        class MoveOnlyFunction;
+        
+        /**
+         * @class MoveOnlyFunction
+         * @brief Move-only type-erased callable.
+         * @discussion Callables that fit into 'kInlineSize' bytes (i.e. lambdas capturing few pointers, std::packaged_task or std::function)
+         * are stored right inside the wrapper without allocating memory. Bigger ones are moved to the heap.
+         * Unlike std::function, move-only callables (i.e. lambdas owning std::unique_ptr) are supported.
+         * @discussion The call is single indirect call through the function pointer.
+         */
+        template <typename R, typename... Args>
+        class MoveOnlyFunction<R(Args...)>
+        {
+        public:
+            static const size_t kInlineSize = 6 * sizeof(void*);
+            
+            MoveOnlyFunction() = default;
+            
+            template <typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, MoveOnlyFunction>::value>::type>
+            MoveOnlyFunction(F&& function);
+            
+            MoveOnlyFunction(MoveOnlyFunction&& other);
+            MoveOnlyFunction& operator=(MoveOnlyFunction&& other);
+            ~MoveOnlyFunction();
+            
+            MoveOnlyFunction(const MoveOnlyFunction&) = delete;
+            MoveOnlyFunction& operator=(const MoveOnlyFunction&) = delete;
+            
+            R operator()(Args... args) const;
+            explicit operator bool() const;
+            
+        private:
+            struct Operations
+            {
+                R (*invoke)(void* storage, Args&&... args);
+                void (*move)(void* from, void* to);
+                void (*destroy)(void* storage);
+            };
+            
+            template <typename F>
+            static R call(F& function, std::false_type, Args&&... args) { return function(std::forward<Args>(args)...); }
+            template <typename F>
+            static void call(F& function, std::true_type, Args&&... args) { function(std::forward<Args>(args)...); }
+            
+            template <typename F>
+            struct InlineOperations
+            {
+                static R invoke(void* storage, Args&&... args) { return call(*static_cast<F*>(storage), std::is_void<R>(), std::forward<Args>(args)...); }
+                static void move(void* from, void* to) { new (to) F(std::move(*static_cast<F*>(from))); destroy(from); }
+                static void destroy(void* storage) { static_cast<F*>(storage)->~F(); }
+                static const Operations operations;
+            };
+            
+            template <typename F>
+            struct HeapOperations
+            {
+                static F*& function(void* storage) { return *static_cast<F**>(storage); }
+                static R invoke(void* storage, Args&&... args) { return call(*function(storage), std::is_void<R>(), std::forward<Args>(args)...); }
+                static void move(void* from, void* to) { new (to) F*(function(from)); }
+                static void destroy(void* storage) { delete function(storage); }
+                static const Operations operations;
+            };
+            
+            template <typename F>
+            using IsInline = std::integral_constant<bool, sizeof(F) <= kInlineSize
+                                                          && std::alignment_of<F>::value <= std::alignment_of<std::max_align_t>::value
+                                                          && std::is_nothrow_move_constructible<F>::value>;
+            
+            template <typename F>
+            void store(F&& function, std::true_type isInline);
+            template <typename F>
+            void store(F&& function, std::false_type isInline);
+            
+            void reset();
+            
+        private:
+            // Mutable as std::function's callable: the wrapper is called as const, the callable is called as is.
+            mutable typename std::aligned_storage<kInlineSize, std::alignment_of<std::max_align_t>::value>::type m_storage;
+            const Operations* m_operations = nullptr;
+        };
+        
+        /**
+         * @brief Closure of the ad-hoc function submitted to the pool.
+         */
+        using Closure = MoveOnlyFunction<void()>;
+    }
+}
+
+template <typename R, typename... Args>
+template <typename F>
+const typename execq::impl::MoveOnlyFunction<R(Args...)>::Operations execq::impl::MoveOnlyFunction<R(Args...)>::InlineOperations<F>::operations = { &invoke, &move, &destroy };
+
+template <typename R, typename... Args>
+template <typename F>
+const typename execq::impl::MoveOnlyFunction<R(Args...)>::Operations execq::impl::MoveOnlyFunction<R(Args...)>::HeapOperations<F>::operations = { &invoke, &move, &destroy };
+
+template <typename R, typename... Args>
+template <typename F, typename>
+execq::impl::MoveOnlyFunction<R(Args...)>::MoveOnlyFunction(F&& function)
+{
+    store(std::forward<F>(function), IsInline<typename std::decay<F>::type>());
+}
+
+template <typename R, typename... Args>
+execq::impl::MoveOnlyFunction<R(Args...)>::MoveOnlyFunction(MoveOnlyFunction&& other)
+{
+    *this = std::move(other);
+}
+
+template <typename R, typename... Args>
+execq::impl::MoveOnlyFunction<R(Args...)>& execq::impl::MoveOnlyFunction<R(Args...)>::operator=(MoveOnlyFunction&& other)
+{
+    if (this != &other)
+    {
+        reset();
+        if (other.m_operations)
+        {
+            other.m_operations->move(&other.m_storage, &m_storage);
+            m_operations = other.m_operations;
+            other.m_operations = nullptr;
+        }
+    }
+    
+    return *this;
+}
+
+template <typename R, typename... Args>
+execq::impl::MoveOnlyFunction<R(Args...)>::~MoveOnlyFunction()
+{
+    reset();
+}
+
+template <typename R, typename... Args>
+R execq::impl::MoveOnlyFunction<R(Args...)>::operator()(Args... args) const
+{
+    return m_operations->invoke(&m_storage, std::forward<Args>(args)...);
+}
+
+template <typename R, typename... Args>
+execq::impl::MoveOnlyFunction<R(Args...)>::operator bool() const
+{
+    return m_operations != nullptr;
+}
+
+template <typename R, typename... Args>
+template <typename F>
+void execq::impl::MoveOnlyFunction<R(Args...)>::store(F&& function, std::true_type)
+{
+    using Function = typename std::decay<F>::type;
+    new (&m_storage) Function(std::forward<F>(function));
+    m_operations = &InlineOperations<Function>::operations;
+}
+
+template <typename R, typename... Args>
+template <typename F>
+void execq::impl::MoveOnlyFunction<R(Args...)>::store(F&& function, std::false_type)
+{
+    using Function = typename std::decay<F>::type;
+    new (&m_storage) Function*(new Function(std::forward<F>(function)));
+    m_operations = &HeapOperations<Function>::operations;
+}
+
+template <typename R, typename... Args>
+void execq::impl::MoveOnlyFunction<R(Args...)>::reset()
+{
+    if (m_operations)
+    {
+        m_operations->destroy(&m_storage);
+        m_operations = nullptr;
+    }
+}
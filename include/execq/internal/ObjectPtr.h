@@ -0,0 +1,364 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+
+namespace execq
+{
+    namespace impl
+    {
+        /**
+         * @class IObjectReleaser
+         * @brief Object pushed into the queue that is released in a custom way after processing.
+         * @discussion Shared, borrowed and recycled objects are pushed this way.
+         */
+        template <typename T>
+        class IObjectReleaser
+        {
+        public:
+            virtual ~IObjectReleaser() = default;
+            
+            virtual T& object() = 0;
+            
+            /**
+             * @brief Called once when the queue doesn't refer the object anymore.
+             * @discussion Releaser may destroy itself here.
+             */
+            virtual void release() = 0;
+        };
+        
+        /**
+         * @brief Releaser of the object shared with the caller: drops the reference.
+         */
+        template <typename T>
+        class SharedObjectReleaser: public IObjectReleaser<T>
+        {
+        public:
+            explicit SharedObjectReleaser(std::shared_ptr<T> object);
+            
+            virtual T& object() final;
+            virtual void release() final;
+            
+        private:
+            const std::shared_ptr<T> m_object;
+        };
+        
+        /**
+         * @brief Releaser of the object owned by the caller: returns the object with 'release' callback.
+         * @discussion Never deletes the object.
+         */
+        template <typename T>
+        class BorrowedObjectReleaser: public IObjectReleaser<T>
+        {
+        public:
+            /**
+             * @discussion Throws std::invalid_argument if 'release' is empty.
+             */
+            BorrowedObjectReleaser(T& object, std::function<void(T& object)> release);
+            
+            virtual T& object() final;
+            virtual void release() final;
+            
+        private:
+            T& m_object;
+            const std::function<void(T& object)> m_release;
+        };
+        
+        /**
+         * @brief Releaser of the object the caller waits for (i.e. in 'dispatchSync'): does nothing with the object.
+         */
+        template <typename T>
+        class UnownedObjectReleaser: public IObjectReleaser<T>
+        {
+        public:
+            explicit UnownedObjectReleaser(T& object);
+            
+            virtual T& object() final;
+            virtual void release() final;
+            
+        private:
+            T& m_object;
+        };
+        
+        /**
+         * @brief Releaser of owned object that can't be tagged (see ObjectPtr): deletes the object.
+         */
+        template <typename T>
+        class OwnedObjectReleaser: public IObjectReleaser<T>
+        {
+        public:
+            explicit OwnedObjectReleaser(std::unique_ptr<T> object);
+            
+            virtual T& object() final;
+            virtual void release() final;
+            
+        private:
+            const std::unique_ptr<T> m_object;
+        };
+        
+        /**
+         * @class ObjectPtr
+         * @brief Object pushed into the queue, released in the way it was pushed.
+         *
+         * @discussion Holds single tagged pointer: either owned object (deleted after processing)
+         * or releaser of shared, borrowed or recycled object. So owned objects cost no more than std::unique_ptr.
+         * @discussion Releasers of shared and borrowed objects are allocated per push, recycled objects are their own releasers.
+         * Owned object with the tag bit set in its address (possible only for types aligned by 1) gets the releaser as well.
+         */
+        template <typename T>
+        class ObjectPtr
+        {
+        public:
+            ObjectPtr() = default;
+            ObjectPtr(std::nullptr_t);
+            ObjectPtr(std::unique_ptr<T> object);
+            
+            /**
+             * @brief Takes ownership over the releaser. 'release' is called when ObjectPtr is destroyed.
+             */
+            explicit ObjectPtr(IObjectReleaser<T>* releaser);
+            
+            ObjectPtr(ObjectPtr&& other) noexcept;
+            ObjectPtr& operator=(ObjectPtr&& other) noexcept;
+            ~ObjectPtr();
+            
+            T* get() const;
+            T& operator*() const;
+            T* operator->() const;
+            explicit operator bool() const;
+            
+            void reset();
+            
+        private:
+            bool isReleaser() const;
+            IObjectReleaser<T>* releaser() const;
+            
+        private:
+            static const std::uintptr_t kReleaserTag = 1;
+            
+            std::uintptr_t m_value = 0;
+        };
+    }
+}
+
+// SharedObjectReleaser
+
+template <typename T>
+execq::impl::SharedObjectReleaser<T>::SharedObjectReleaser(std::shared_ptr<T> object)
+: m_object(std::move(object))
+{}
+
+template <typename T>
+T& execq::impl::SharedObjectReleaser<T>::object()
+{
+    return *m_object;
+}
+
+template <typename T>
+void execq::impl::SharedObjectReleaser<T>::release()
+{
+    delete this;
+}
+
+// BorrowedObjectReleaser
+
+template <typename T>
+execq::impl::BorrowedObjectReleaser<T>::BorrowedObjectReleaser(T& object, std::function<void(T& object)> release)
+: m_object(object)
+, m_release(std::move(release))
+{
+    if (!m_release)
+    {
+        throw std::invalid_argument("Failed to push object: release function is empty.");
+    }
+}
+
+template <typename T>
+T& execq::impl::BorrowedObjectReleaser<T>::object()
+{
+    return m_object;
+}
+
+template <typename T>
+void execq::impl::BorrowedObjectReleaser<T>::release()
+{
+    std::unique_ptr<BorrowedObjectReleaser> guard(this);
+    m_release(m_object);
+}
+
+// UnownedObjectReleaser
+
+template <typename T>
+execq::impl::UnownedObjectReleaser<T>::UnownedObjectReleaser(T& object)
+: m_object(object)
+{}
+
+template <typename T>
+T& execq::impl::UnownedObjectReleaser<T>::object()
+{
+    return m_object;
+}
+
+template <typename T>
+void execq::impl::UnownedObjectReleaser<T>::release()
+{
+    delete this;
+}
+
+// OwnedObjectReleaser
+
+template <typename T>
+execq::impl::OwnedObjectReleaser<T>::OwnedObjectReleaser(std::unique_ptr<T> object)
+: m_object(std::move(object))
+{}
+
+template <typename T>
+T& execq::impl::OwnedObjectReleaser<T>::object()
+{
+    return *m_object;
+}
+
+template <typename T>
+void execq::impl::OwnedObjectReleaser<T>::release()
+{
+    delete this;
+}
+
+// ObjectPtr
+
+template <typename T>
+execq::impl::ObjectPtr<T>::ObjectPtr(std::nullptr_t)
+{}
+
+template <typename T>
+execq::impl::ObjectPtr<T>::ObjectPtr(std::unique_ptr<T> object)
+: m_value(reinterpret_cast<std::uintptr_t>(object.get()))
+{
+    if (m_value & kReleaserTag)
+    {
+        // Objects of types aligned by 1 may have the tag bit set. Rare, so such objects just get a releaser.
+        m_value = reinterpret_cast<std::uintptr_t>(static_cast<IObjectReleaser<T>*>(new OwnedObjectReleaser<T>(std::move(object)))) | kReleaserTag;
+    }
+    else
+    {
+        object.release();
+    }
+}
+
+template <typename T>
+execq::impl::ObjectPtr<T>::ObjectPtr(IObjectReleaser<T>* releaser)
+: m_value(releaser ? reinterpret_cast<std::uintptr_t>(releaser) | kReleaserTag : 0)
+{
+    static_assert(alignof(IObjectReleaser<T>) > kReleaserTag, "Releaser pointer has no room for the tag.");
+}
+
+template <typename T>
+execq::impl::ObjectPtr<T>::ObjectPtr(ObjectPtr&& other) noexcept
+: m_value(other.m_value)
+{
+    other.m_value = 0;
+}
+
+template <typename T>
+execq::impl::ObjectPtr<T>& execq::impl::ObjectPtr<T>::operator=(ObjectPtr&& other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        m_value = other.m_value;
+        other.m_value = 0;
+    }
+    
+    return *this;
+}
+
+template <typename T>
+execq::impl::ObjectPtr<T>::~ObjectPtr()
+{
+    reset();
+}
+
+template <typename T>
+T* execq::impl::ObjectPtr<T>::get() const
+{
+    if (isReleaser())
+    {
+        return &releaser()->object();
+    }
+    
+    return reinterpret_cast<T*>(m_value);
+}
+
+template <typename T>
+T& execq::impl::ObjectPtr<T>::operator*() const
+{
+    return *get();
+}
+
+template <typename T>
+T* execq::impl::ObjectPtr<T>::operator->() const
+{
+    return get();
+}
+
+template <typename T>
+execq::impl::ObjectPtr<T>::operator bool() const
+{
+    return m_value != 0;
+}
+
+template <typename T>
+void execq::impl::ObjectPtr<T>::reset()
+{
+    const std::uintptr_t value = m_value;
+    const bool hasReleaser = isReleaser();
+    m_value = 0;
+    
+    if (hasReleaser)
+    {
+        reinterpret_cast<IObjectReleaser<T>*>(value & ~kReleaserTag)->release();
+    }
+    else
+    {
+        delete reinterpret_cast<T*>(value);
+    }
+}
+
+template <typename T>
+bool execq::impl::ObjectPtr<T>::isReleaser() const
+{
+    return (m_value & kReleaserTag) != 0;
+}
+
+template <typename T>
+execq::impl::IObjectReleaser<T>* execq::impl::ObjectPtr<T>::releaser() const
+{
+    return reinterpret_cast<IObjectReleaser<T>*>(m_value & ~kReleaserTag);
+}
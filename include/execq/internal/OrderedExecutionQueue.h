@@ -0,0 +1,297 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/IOrderedExecutionQueue.h"
+#include "execq/internal/ExecutionQueue.h"
+
+#include <stdexcept>
+#include <type_traits>
+
+namespace execq
+{
+    namespace impl
+    {
+        template <typename T>
+        struct OrderedObject
+        {
+            uint64_t index;
+            T object;
+        };
+        
+        /**
+         * @brief Place in the reorder window where the result waits until all previous results are completed.
+         */
+        template <typename R>
+        class OrderedSlot
+        {
+        public:
+            ~OrderedSlot();
+            
+            bool ready() const;
+            void set(R&& result);
+            R take();
+            
+        private:
+            typename std::aligned_storage<sizeof(R), alignof(R)>::type m_storage;
+            bool m_ready = false;
+        };
+        
+        template <>
+        class OrderedSlot<void>
+        {
+        public:
+            bool ready() const { return m_ready; }
+            void set() { m_ready = true; }
+            void take() { m_ready = false; }
+            
+        private:
+            bool m_ready = false;
+        };
+        
+        template <typename T, typename R>
+        class OrderedExecutionQueue: public IOrderedExecutionQueue<T>
+        {
+        public:
+            OrderedExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                  const IThreadWorkerFactory& workerFactory,
+                                  const size_t reorderWindow,
+                                  std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                  typename OrderedCompletion<R>::Type completion);
+            ~OrderedExecutionQueue();
+            
+        public: // IOrderedExecutionQueue
+            virtual void push(T&& object) final;
+            virtual bool tryPush(T&& object) final;
+            virtual void cancel() final;
+            
+        private:
+            void execute(const std::atomic_bool& isCanceled, OrderedObject<T>&& object);
+            void store(OrderedSlot<R>& slot, const std::atomic_bool& isCanceled, T&& object, std::false_type /*voidResult*/);
+            void store(OrderedSlot<R>& slot, const std::atomic_bool& isCanceled, T&& object, std::true_type /*voidResult*/);
+            void complete(OrderedSlot<R>& slot, std::false_type /*voidResult*/);
+            void complete(OrderedSlot<R>& slot, std::true_type /*voidResult*/);
+            
+            void completeReadyResults(std::unique_lock<std::mutex>& lock);
+            bool windowIsFull() const;
+            
+        private:
+            std::vector<OrderedSlot<R>> m_slots;
+            uint64_t m_pushedCount = 0;
+            uint64_t m_completedCount = 0;
+            bool m_isCompleting = false;
+            std::mutex m_mutex;
+            std::condition_variable m_windowCondition;
+            
+            const std::function<R(const std::atomic_bool& isCanceled, T&& object)> m_executor;
+            const typename OrderedCompletion<R>::Type m_completion;
+            
+            std::unique_ptr<ExecutionQueue<OrderedObject<T>, void>> m_queue;
+        };
+    }
+}
+
+// OrderedSlot
+
+template <typename R>
+execq::impl::OrderedSlot<R>::~OrderedSlot()
+{
+    if (m_ready)
+    {
+        take();
+    }
+}
+
+template <typename R>
+bool execq::impl::OrderedSlot<R>::ready() const
+{
+    return m_ready;
+}
+
+template <typename R>
+void execq::impl::OrderedSlot<R>::set(R&& result)
+{
+    new (&m_storage) R(std::move(result));
+    m_ready = true;
+}
+
+template <typename R>
+R execq::impl::OrderedSlot<R>::take()
+{
+    R* const stored = reinterpret_cast<R*>(&m_storage);
+    R result(std::move(*stored));
+    stored->~R();
+    m_ready = false;
+    
+    return result;
+}
+
+// OrderedExecutionQueue
+
+template <typename T, typename R>
+execq::impl::OrderedExecutionQueue<T, R>::OrderedExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                const IThreadWorkerFactory& workerFactory,
+                                                                const size_t reorderWindow,
+                                                                std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                                                typename OrderedCompletion<R>::Type completion)
+: m_slots(std::max<size_t>(reorderWindow, 1))
+, m_executor(std::move(executor))
+, m_completion(std::move(completion))
+{
+    if (!executionPool)
+    {
+        throw std::invalid_argument("Failed to create queue: execution pool is null.");
+    }
+    
+    m_queue.reset(new ExecutionQueue<OrderedObject<T>, void>(false, executionPool, workerFactory,
+                                                             [this] (const std::atomic_bool& isCanceled, OrderedObject<T>&& object) {
+                                                                 execute(isCanceled, std::move(object));
+                                                             }));
+}
+
+template <typename T, typename R>
+execq::impl::OrderedExecutionQueue<T, R>::~OrderedExecutionQueue()
+{
+    // Waits until all objects are processed and completed.
+    m_queue.reset();
+}
+
+// IOrderedExecutionQueue
+
+template <typename T, typename R>
+void execq::impl::OrderedExecutionQueue<T, R>::push(T&& object)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (windowIsFull())
+    {
+        m_windowCondition.wait(lock);
+    }
+    
+    const uint64_t index = m_pushedCount++;
+    lock.unlock();
+    
+    m_queue->push(OrderedObject<T> { index, std::move(object) });
+}
+
+template <typename T, typename R>
+bool execq::impl::OrderedExecutionQueue<T, R>::tryPush(T&& object)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (windowIsFull())
+    {
+        return false;
+    }
+    
+    const uint64_t index = m_pushedCount++;
+    lock.unlock();
+    
+    m_queue->push(OrderedObject<T> { index, std::move(object) });
+    return true;
+}
+
+template <typename T, typename R>
+void execq::impl::OrderedExecutionQueue<T, R>::cancel()
+{
+    m_queue->cancel();
+}
+
+// Private
+
+template <typename T, typename R>
+void execq::impl::OrderedExecutionQueue<T, R>::execute(const std::atomic_bool& isCanceled, OrderedObject<T>&& object)
+{
+    // Slot is not shared with other objects in flight: they all are within the window.
+    OrderedSlot<R>& slot = m_slots[object.index % m_slots.size()];
+    store(slot, isCanceled, std::move(object.object), std::is_void<R>());
+    
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_isCompleting && object.index == m_completedCount)
+    {
+        completeReadyResults(lock);
+    }
+}
+
+template <typename T, typename R>
+void execq::impl::OrderedExecutionQueue<T, R>::store(OrderedSlot<R>& slot, const std::atomic_bool& isCanceled, T&& object, std::false_type /*voidResult*/)
+{
+    R result = m_executor(isCanceled, std::move(object));
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    slot.set(std::move(result));
+}
+
+template <typename T, typename R>
+void execq::impl::OrderedExecutionQueue<T, R>::store(OrderedSlot<R>& slot, const std::atomic_bool& isCanceled, T&& object, std::true_type /*voidResult*/)
+{
+    m_executor(isCanceled, std::move(object));
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    slot.set();
+}
+
+template <typename T, typename R>
+void execq::impl::OrderedExecutionQueue<T, R>::complete(OrderedSlot<R>& slot, std::false_type /*voidResult*/)
+{
+    m_completion(slot.take());
+}
+
+template <typename T, typename R>
+void execq::impl::OrderedExecutionQueue<T, R>::complete(OrderedSlot<R>& slot, std::true_type /*voidResult*/)
+{
+    slot.take();
+    m_completion();
+}
+
+template <typename T, typename R>
+void execq::impl::OrderedExecutionQueue<T, R>::completeReadyResults(std::unique_lock<std::mutex>& lock)
+{
+    // Only one thread completes results at a time. Other threads just leave their results in the window.
+    m_isCompleting = true;
+    
+    while (true)
+    {
+        OrderedSlot<R>& slot = m_slots[m_completedCount % m_slots.size()];
+        if (!slot.ready())
+        {
+            break;
+        }
+        
+        // Slot can't be reused until 'm_completedCount' is incremented.
+        lock.unlock();
+        complete(slot, std::is_void<R>());
+        lock.lock();
+        
+        m_completedCount++;
+        m_windowCondition.notify_all();
+    }
+    
+    m_isCompleting = false;
+}
+
+template <typename T, typename R>
+bool execq::impl::OrderedExecutionQueue<T, R>::windowIsFull() const
+{
+    return m_pushedCount - m_completedCount >= m_slots.size();
+}
@@ -0,0 +1,618 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/IPipeline.h"
+#include "execq/internal/CancelTokenProvider.h"
+#include "execq/internal/ExecutionPool.h"
+
+#include <condition_variable>
+#include <stdexcept>
+#include <type_traits>
+
+namespace execq
+{
+    namespace impl
+    {
+        /**
+         * @brief Fixed-capacity ring buffer. Storage is allocated once on construction.
+         * @discussion Objects are moved in and out. Not thread-safe.
+         */
+        template <typename T>
+        class BoundedBuffer
+        {
+        public:
+            explicit BoundedBuffer(const size_t capacity);
+            ~BoundedBuffer();
+            
+            size_t size() const;
+            size_t capacity() const;
+            
+            void push(T&& object);
+            T pop();
+            
+        private:
+            using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+            
+            T* objectAt(const size_t index);
+            
+        private:
+            const size_t m_capacity = 0;
+            const std::unique_ptr<Storage[]> m_storage;
+            size_t m_head = 0;
+            size_t m_size = 0;
+        };
+        
+        template <typename T>
+        struct PipelineItem
+        {
+            T object;
+            CancelToken cancelToken;
+        };
+        
+        class IPipelineStage
+        {
+        public:
+            virtual ~IPipelineStage() = default;
+            
+            virtual void waitDrained() = 0;
+        };
+        
+        class IPipelineCreditListener
+        {
+        public:
+            virtual ~IPipelineCreditListener() = default;
+            
+            /**
+             * @brief Called when the next stage has got free space in its buffer.
+             */
+            virtual void onCreditAvailable() = 0;
+        };
+        
+        template <typename T>
+        class IPipelineInput
+        {
+        public:
+            virtual ~IPipelineInput() = default;
+            
+            /**
+             * @brief Reserves a place in the buffer. Must be followed by exactly one 'pushReserved' call.
+             * @return false if the buffer is full.
+             */
+            virtual bool reserve() = 0;
+            virtual void pushReserved(PipelineItem<T> item) = 0;
+            
+            virtual void setUpstream(IPipelineCreditListener* upstream) = 0;
+        };
+        
+        template <typename T>
+        class IPipelineOutput
+        {
+        public:
+            virtual ~IPipelineOutput() = default;
+            
+            virtual void setNext(IPipelineInput<T>* next) = 0;
+        };
+        
+        template <typename In, typename Out>
+        class PipelineStage: public IPipelineStage, public IPipelineInput<In>, public IPipelineOutput<Out>,
+        private IPipelineCreditListener, private ITaskProvider
+        {
+        public:
+            PipelineStage(const bool serial, const size_t capacity, std::shared_ptr<IExecutionPool> executionPool,
+                          const IThreadWorkerFactory& workerFactory,
+                          std::function<Out(const std::atomic_bool& isCanceled, In&& object)> executor);
+            ~PipelineStage();
+            
+        public: // IPipelineStage
+            virtual void waitDrained() final;
+            
+        public: // IPipelineInput
+            virtual bool reserve() final;
+            virtual void pushReserved(PipelineItem<In> item) final;
+            virtual void setUpstream(IPipelineCreditListener* upstream) final;
+            
+        public: // IPipelineOutput
+            virtual void setNext(IPipelineInput<Out>* next) final;
+            
+        private: // IPipelineCreditListener
+            virtual void onCreditAvailable() final;
+            
+        private: // IThreadWorkerPoolTaskProvider
+            virtual Task nextTask() final;
+            
+        private:
+            void execute(PipelineItem<In>&& item, std::true_type /*voidResult*/);
+            void execute(PipelineItem<In>&& item, std::false_type /*voidResult*/);
+            
+            PipelineItem<In> popClaimedItem();
+            bool hasUnclaimedItems() const;
+            void notifyWorkers();
+            
+        private:
+            BoundedBuffer<PipelineItem<In>> m_buffer;
+            size_t m_reservedCount = 0;
+            size_t m_claimedCount = 0;
+            size_t m_runningCount = 0;
+            std::mutex m_mutex;
+            std::condition_variable m_drainedCondition;
+            
+            IPipelineInput<Out>* m_next = nullptr;
+            IPipelineCreditListener* m_upstream = nullptr;
+            
+            const bool m_isSerial = false;
+            const std::shared_ptr<IExecutionPool> m_executionPool;
+            const std::function<Out(const std::atomic_bool& isCanceled, In&& object)> m_executor;
+            
+            const std::unique_ptr<IThreadWorker> m_additionalWorker;
+        };
+        
+        template <typename T>
+        class Pipeline: public IPipeline<T>, private IPipelineCreditListener
+        {
+        public:
+            Pipeline(std::vector<std::unique_ptr<IPipelineStage>> stages, IPipelineInput<T>& input);
+            ~Pipeline();
+            
+        public: // IPipeline
+            virtual void push(T&& object) final;
+            virtual bool tryPush(T&& object) final;
+            virtual void cancel() final;
+            
+        private: // IPipelineCreditListener
+            virtual void onCreditAvailable() final;
+            
+        private:
+            std::vector<std::unique_ptr<IPipelineStage>> m_stages;
+            IPipelineInput<T>& m_input;
+            
+            std::mutex m_sourceMutex;
+            std::condition_variable m_sourceCondition;
+            
+            CancelTokenProvider m_cancelTokenProvider;
+        };
+        
+        /**
+         * @brief Casts input of the first stage to the input of the pipeline.
+         * @discussion Used only when the stage is the first one, so its input type is the pipeline's one.
+         * Instantiated for later stages as well, where types differ: nullptr is returned then.
+         */
+        template <typename In, typename Out>
+        struct PipelineInputCast
+        {
+            static IPipelineInput<In>* cast(IPipelineInput<Out>*) { return nullptr; }
+        };
+        
+        template <typename T>
+        struct PipelineInputCast<T, T>
+        {
+            static IPipelineInput<T>* cast(IPipelineInput<T>* input) { return input; }
+        };
+    }
+}
+
+// BoundedBuffer
+
+template <typename T>
+execq::impl::BoundedBuffer<T>::BoundedBuffer(const size_t capacity)
+: m_capacity(capacity)
+, m_storage(new Storage[capacity])
+{}
+
+template <typename T>
+execq::impl::BoundedBuffer<T>::~BoundedBuffer()
+{
+    while (m_size)
+    {
+        pop();
+    }
+}
+
+template <typename T>
+size_t execq::impl::BoundedBuffer<T>::size() const
+{
+    return m_size;
+}
+
+template <typename T>
+size_t execq::impl::BoundedBuffer<T>::capacity() const
+{
+    return m_capacity;
+}
+
+template <typename T>
+void execq::impl::BoundedBuffer<T>::push(T&& object)
+{
+    new (objectAt((m_head + m_size) % m_capacity)) T(std::move(object));
+    m_size++;
+}
+
+template <typename T>
+T execq::impl::BoundedBuffer<T>::pop()
+{
+    T* const stored = objectAt(m_head);
+    T object(std::move(*stored));
+    stored->~T();
+    
+    m_head = (m_head + 1) % m_capacity;
+    m_size--;
+    
+    return object;
+}
+
+template <typename T>
+T* execq::impl::BoundedBuffer<T>::objectAt(const size_t index)
+{
+    return reinterpret_cast<T*>(&m_storage[index]);
+}
+
+// PipelineStage
+
+template <typename In, typename Out>
+execq::impl::PipelineStage<In, Out>::PipelineStage(const bool serial, const size_t capacity, std::shared_ptr<IExecutionPool> executionPool,
+                                                   const IThreadWorkerFactory& workerFactory,
+                                                   std::function<Out(const std::atomic_bool& isCanceled, In&& object)> executor)
+: m_buffer(std::max<size_t>(capacity, 1))
+, m_isSerial(serial)
+, m_executionPool(executionPool)
+, m_executor(std::move(executor))
+, m_additionalWorker(workerFactory.createWorker(*this))
+{
+    m_executionPool->addProvider(*this);
+}
+
+template <typename In, typename Out>
+execq::impl::PipelineStage<In, Out>::~PipelineStage()
+{
+    waitDrained();
+    m_executionPool->removeProvider(*this);
+}
+
+template <typename In, typename Out>
+void execq::impl::PipelineStage<In, Out>::setNext(IPipelineInput<Out>* next)
+{
+    m_next = next;
+    if (m_next)
+    {
+        m_next->setUpstream(this);
+    }
+}
+
+// IPipelineStage
+
+template <typename In, typename Out>
+void execq::impl::PipelineStage<In, Out>::waitDrained()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_buffer.size() || m_reservedCount || m_runningCount)
+    {
+        m_drainedCondition.wait(lock);
+    }
+}
+
+// IPipelineInput
+
+template <typename In, typename Out>
+bool execq::impl::PipelineStage<In, Out>::reserve()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_buffer.size() + m_reservedCount >= m_buffer.capacity())
+    {
+        return false;
+    }
+    
+    m_reservedCount++;
+    return true;
+}
+
+template <typename In, typename Out>
+void execq::impl::PipelineStage<In, Out>::pushReserved(PipelineItem<In> item)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_reservedCount--;
+    m_buffer.push(std::move(item));
+    
+    notifyWorkers();
+}
+
+template <typename In, typename Out>
+void execq::impl::PipelineStage<In, Out>::setUpstream(IPipelineCreditListener* upstream)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_upstream = upstream;
+}
+
+// IPipelineCreditListener
+
+template <typename In, typename Out>
+void execq::impl::PipelineStage<In, Out>::onCreditAvailable()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (hasUnclaimedItems())
+    {
+        notifyWorkers();
+    }
+}
+
+// IThreadWorkerPoolTaskProvider
+
+template <typename In, typename Out>
+execq::impl::Task execq::impl::PipelineStage<In, Out>::nextTask()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!hasUnclaimedItems() || (m_isSerial && m_runningCount))
+    {
+        return Task();
+    }
+    
+    // Credit-based backpressure: do not take an object unless the next stage can accept the result.
+    if (m_next && !m_next->reserve())
+    {
+        return Task();
+    }
+    
+    m_claimedCount++;
+    m_runningCount++;
+    
+    return Task([this] {
+        execute(popClaimedItem(), std::is_void<Out>());
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_runningCount--;
+        
+        // Current thread looks for the next task right away, so the stage doesn't need its own worker here.
+        if (m_isSerial && hasUnclaimedItems() && !m_executionPool->notifyOneWorker())
+        {
+            m_additionalWorker->notifyWorker();
+        }
+        
+        if (!m_runningCount && !m_buffer.size() && !m_reservedCount)
+        {
+            m_drainedCondition.notify_all();
+        }
+    });
+}
+
+// Private
+
+template <typename In, typename Out>
+void execq::impl::PipelineStage<In, Out>::execute(PipelineItem<In>&& item, std::true_type /*voidResult*/)
+{
+    m_executor(*item.cancelToken, std::move(item.object));
+}
+
+template <typename In, typename Out>
+void execq::impl::PipelineStage<In, Out>::execute(PipelineItem<In>&& item, std::false_type /*voidResult*/)
+{
+    Out result = m_executor(*item.cancelToken, std::move(item.object));
+    if (m_next)
+    {
+        m_next->pushReserved({ std::move(result), std::move(item.cancelToken) });
+    }
+}
+
+template <typename In, typename Out>
+execq::impl::PipelineItem<In> execq::impl::PipelineStage<In, Out>::popClaimedItem()
+{
+    IPipelineCreditListener* upstream = nullptr;
+    PipelineItem<In> item = [&] {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_claimedCount--;
+        upstream = m_upstream;
+        return m_buffer.pop();
+    }();
+    
+    if (upstream)
+    {
+        upstream->onCreditAvailable();
+    }
+    
+    return item;
+}
+
+template <typename In, typename Out>
+bool execq::impl::PipelineStage<In, Out>::hasUnclaimedItems() const
+{
+    return m_claimedCount < m_buffer.size();
+}
+
+template <typename In, typename Out>
+void execq::impl::PipelineStage<In, Out>::notifyWorkers()
+{
+    // Notified pool worker may be busy with a long task of another stage. With nothing of this stage running,
+    // the stage's own worker is woken as well: otherwise its items (and so the stages behind it) wait for that task.
+    if (!m_executionPool->notifyOneWorker() || !m_runningCount)
+    {
+        m_additionalWorker->notifyWorker();
+    }
+}
+
+// Pipeline
+
+template <typename T>
+execq::impl::Pipeline<T>::Pipeline(std::vector<std::unique_ptr<IPipelineStage>> stages, IPipelineInput<T>& input)
+: m_stages(std::move(stages))
+, m_input(input)
+{
+    m_input.setUpstream(this);
+}
+
+template <typename T>
+execq::impl::Pipeline<T>::~Pipeline()
+{
+    m_cancelTokenProvider.cancel();
+    
+    // Stages are drained from first to last: objects of the first stage may still go to the next ones.
+    for (const auto& stage : m_stages)
+    {
+        stage->waitDrained();
+    }
+    
+    while (!m_stages.empty())
+    {
+        m_stages.pop_back();
+    }
+}
+
+// IPipeline
+
+template <typename T>
+void execq::impl::Pipeline<T>::push(T&& object)
+{
+    std::unique_lock<std::mutex> lock(m_sourceMutex);
+    while (!m_input.reserve())
+    {
+        m_sourceCondition.wait(lock);
+    }
+    lock.unlock();
+    
+    m_input.pushReserved({ std::move(object), m_cancelTokenProvider.token() });
+}
+
+template <typename T>
+bool execq::impl::Pipeline<T>::tryPush(T&& object)
+{
+    if (!m_input.reserve())
+    {
+        return false;
+    }
+    
+    m_input.pushReserved({ std::move(object), m_cancelTokenProvider.token() });
+    return true;
+}
+
+template <typename T>
+void execq::impl::Pipeline<T>::cancel()
+{
+    m_cancelTokenProvider.cancelAndRenew();
+}
+
+// IPipelineCreditListener
+
+template <typename T>
+void execq::impl::Pipeline<T>::onCreditAvailable()
+{
+    std::lock_guard<std::mutex> lock(m_sourceMutex);
+    m_sourceCondition.notify_all();
+}
+
+// PipelineBuilder
+
+template <typename In, typename Out>
+execq::PipelineBuilder<In, Out>::PipelineBuilder(std::shared_ptr<IExecutionPool> executionPool)
+: m_executionPool(executionPool)
+{
+    if (!m_executionPool)
+    {
+        throw std::invalid_argument("Failed to create pipeline: execution pool is null.");
+    }
+}
+
+template <typename In, typename Out>
+execq::PipelineBuilder<In, Out>::PipelineBuilder(PipelineBuilder&& other)
+: m_executionPool(other.m_executionPool)
+, m_stages(std::move(other.m_stages))
+, m_input(other.m_input)
+, m_output(other.m_output)
+, m_isUsed(other.m_isUsed)
+{
+    other.m_input = nullptr;
+    other.m_output = nullptr;
+    other.m_isUsed = true;
+}
+
+template <typename In, typename Out>
+template <typename Next>
+execq::PipelineBuilder<In, Next> execq::PipelineBuilder<In, Out>::serial(const size_t capacity,
+                                                                         typename impl::PipelineExecutor<Out, Next>::Type executor)
+{
+    return addStage<Next>(true, capacity, std::move(executor));
+}
+
+template <typename In, typename Out>
+template <typename Next>
+execq::PipelineBuilder<In, Next> execq::PipelineBuilder<In, Out>::parallel(const size_t capacity,
+                                                                           typename impl::PipelineExecutor<Out, Next>::Type executor)
+{
+    return addStage<Next>(false, capacity, std::move(executor));
+}
+
+template <typename In, typename Out>
+std::unique_ptr<execq::IPipeline<In>> execq::PipelineBuilder<In, Out>::build()
+{
+    checkNotUsed();
+    if (!m_input)
+    {
+        throw std::runtime_error("Failed to build pipeline: no stages were added.");
+    }
+    
+    impl::IPipelineInput<In>& input = *m_input;
+    m_input = nullptr;
+    m_output = nullptr;
+    m_isUsed = true;
+    
+    return std::unique_ptr<impl::Pipeline<In>>(new impl::Pipeline<In>(std::move(m_stages), input));
+}
+
+template <typename In, typename Out>
+template <typename Next>
+execq::PipelineBuilder<In, Next> execq::PipelineBuilder<In, Out>::addStage(const bool serial, const size_t capacity,
+                                                                           typename impl::PipelineExecutor<Out, Next>::Type executor)
+{
+    checkNotUsed();
+    
+    impl::PipelineStage<Out, Next>* const stage = new impl::PipelineStage<Out, Next>(serial,
+                                                                                     capacity,
+                                                                                     m_executionPool,
+                                                                                     *impl::IThreadWorkerFactory::defaultFactory(),
+                                                                                     std::move(executor));
+    
+    PipelineBuilder<In, Next> builder(m_executionPool);
+    builder.m_stages = std::move(m_stages);
+    builder.m_stages.emplace_back(stage);
+    builder.m_input = m_input ? m_input : impl::PipelineInputCast<In, Out>::cast(stage);
+    builder.m_output = stage;
+    
+    if (m_output)
+    {
+        m_output->setNext(stage);
+    }
+    
+    m_input = nullptr;
+    m_output = nullptr;
+    m_isUsed = true;
+    
+    return builder;
+}
+
+template <typename In, typename Out>
+void execq::PipelineBuilder<In, Out>::checkNotUsed() const
+{
+    // Stages of the used builder have been moved to the next builder or to the pipeline.
+    if (m_isUsed)
+    {
+        throw std::logic_error("Failed to use pipeline builder: builder has already been used.");
+    }
+}
@@ -0,0 +1,183 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace execq
+{
+    namespace impl
+    {
+        /**
+         * @class RealtimeRing
+         * @brief Bounded multi-producer multi-consumer ring of pre-allocated object slots.
+         * @discussion 'tryPush' neither locks nor allocates: it claims the slot with single compare-and-swap
+         * (that never fails if there is only one producer) and move-constructs the object in place.
+         */
+        template <typename T>
+        class RealtimeRing
+        {
+        public:
+            explicit RealtimeRing(const size_t capacity);
+            ~RealtimeRing();
+            
+            /**
+             * @brief Moves the object into the free slot.
+             * @return false if all slots are occupied. The object is left untouched in such case.
+             */
+            bool tryPush(T&& object);
+            
+            /**
+             * @brief Moves the oldest object out of its slot to the heap.
+             * @return nullptr if the ring is empty.
+             */
+            std::unique_ptr<T> tryPop();
+            
+        private:
+            struct Slot
+            {
+                // Sequence numbers are sequentially consistent: consumers that clear
+                // the 'has objects' flag before popping never miss the object pushed meanwhile.
+                std::atomic_size_t sequence;
+                typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+            };
+            
+            // Objects are moved in and out of the slots. Non-movable types just can't be used with the ring.
+            static void moveConstruct(void* storage, T& object, std::true_type) { new (storage) T(std::move(object)); }
+            static void moveConstruct(void*, T&, std::false_type) {}
+            static T* moveToHeap(T& object, std::true_type) { return new T(std::move(object)); }
+            static T* moveToHeap(T&, std::false_type) { return nullptr; }
+            
+        private:
+            std::unique_ptr<Slot[]> m_slots;
+            const size_t m_mask = 0;
+            
+            std::atomic_size_t m_pushPosition { 0 };
+            std::atomic_size_t m_popPosition { 0 };
+        };
+        
+        namespace details
+        {
+            inline size_t RoundUpToPowerOfTwo(const size_t value)
+            {
+                size_t result = 1;
+                while (result < value)
+                {
+                    result <<= 1;
+                }
+                
+                return result;
+            }
+        }
+    }
+}
+
+template <typename T>
+execq::impl::RealtimeRing<T>::RealtimeRing(const size_t capacity)
+: m_slots(new Slot[details::RoundUpToPowerOfTwo(capacity)])
+, m_mask(details::RoundUpToPowerOfTwo(capacity) - 1)
+{
+    if (!capacity)
+    {
+        throw std::invalid_argument("Failed to create realtime ring: capacity is zero.");
+    }
+    
+    if (!std::is_move_constructible<T>::value)
+    {
+        throw std::invalid_argument("Failed to create realtime ring: object type is not movable.");
+    }
+    
+    for (size_t i = 0; i <= m_mask; i++)
+    {
+        m_slots[i].sequence = i;
+    }
+}
+
+template <typename T>
+execq::impl::RealtimeRing<T>::~RealtimeRing()
+{
+    while (tryPop())
+    {}
+}
+
+template <typename T>
+bool execq::impl::RealtimeRing<T>::tryPush(T&& object)
+{
+    size_t position = m_pushPosition.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Slot& slot = m_slots[position & m_mask];
+        const intptr_t difference = static_cast<intptr_t>(slot.sequence) - static_cast<intptr_t>(position);
+        if (difference < 0)
+        {
+            return false;
+        }
+        
+        if (difference > 0)
+        {
+            position = m_pushPosition.load(std::memory_order_relaxed);
+        }
+        else if (m_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        {
+            moveConstruct(&slot.storage, object, std::is_move_constructible<T>());
+            slot.sequence = position + 1;
+            
+            return true;
+        }
+    }
+}
+
+template <typename T>
+std::unique_ptr<T> execq::impl::RealtimeRing<T>::tryPop()
+{
+    size_t position = m_popPosition.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Slot& slot = m_slots[position & m_mask];
+        const intptr_t difference = static_cast<intptr_t>(slot.sequence) - static_cast<intptr_t>(position + 1);
+        if (difference < 0)
+        {
+            return nullptr;
+        }
+        
+        if (difference > 0)
+        {
+            position = m_popPosition.load(std::memory_order_relaxed);
+        }
+        else if (m_popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        {
+            T& stored = reinterpret_cast<T&>(slot.storage);
+            std::unique_ptr<T> object(moveToHeap(stored, std::is_move_constructible<T>()));
+            stored.~T();
+            slot.sequence = position + m_mask + 1;
+            
+            return object;
+        }
+    }
+}
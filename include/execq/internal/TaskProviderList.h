@@ -28,6 +28,7 @@
 
 #include <mutex>
 #include <list>
+#include <functional>
 
 namespace execq
 {
@@ -39,6 +40,13 @@ namespace execq
             virtual Task nextTask() final;
             
         public:
+            using ProviderFilter = std::function<bool(const ITaskProvider& provider)>;
+            
+            /**
+             * @brief Same as 'nextTask', but skips providers for which 'filter' returns false.
+             */
+            Task nextTask(const ProviderFilter& filter);
+            
             void addProvider(ITaskProvider& provider);
             void removeProvider(ITaskProvider& provider);
             
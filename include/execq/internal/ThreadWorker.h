@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include "execq/internal/TaskAffinity.h"
+
 #include <mutex>
 #include <atomic>
 #include <thread>
@@ -41,6 +43,12 @@ namespace execq
             virtual ~ITaskProvider() = default;
             
             virtual Task nextTask() = 0;
+            
+            /**
+             * @brief Pool threads the provider prefers to be executed on.
+             * @return nullptr if provider has no preferences.
+             */
+            virtual const TaskAffinity* affinity() const { return nullptr; }
         };
         
         
@@ -50,6 +58,19 @@ namespace execq
             virtual ~IThreadWorker() = default;
             
             virtual bool notifyWorker() = 0;
+            
+            /**
+             * @brief Starts the worker and prepares it to be woken up with 'signalWorker'.
+             * @discussion Must be called before the first 'signalWorker' call.
+             */
+            virtual void enableSignals() = 0;
+            
+            /**
+             * @brief Wakes up the worker without taking any locks.
+             * @discussion Safe to be called from real-time threads. The worker waits on a semaphore,
+             * so the wakeup is never lost even if it races with the worker falling asleep.
+             */
+            virtual void signalWorker() = 0;
         };
         
         
@@ -62,6 +83,47 @@ namespace execq
             
             virtual std::unique_ptr<impl::IThreadWorker> createWorker(impl::ITaskProvider& provider) const = 0;
         };
+        
+        
+        /**
+         * @class ExclusiveTaskGuard
+         * @brief Marks the current thread as executing the task that holds serial queue (or target) slot.
+         * @discussion Such thread doesn't help: helped task may wait for the same slot,
+         * which is never freed because its owner is below on the stack.
+         */
+        class ExclusiveTaskGuard
+        {
+        public:
+            explicit ExclusiveTaskGuard(const bool isExclusive);
+            ~ExclusiveTaskGuard();
+            
+            ExclusiveTaskGuard(const ExclusiveTaskGuard&) = delete;
+            ExclusiveTaskGuard& operator=(const ExclusiveTaskGuard&) = delete;
+            
+        private:
+            const bool m_isExclusive;
+        };
+        
+        
+        /**
+         * @brief Checks if the current thread may execute other tasks while it waits for a result.
+         * @return false if the current thread is not a worker thread, it executes exclusive task
+         * (see ExclusiveTaskGuard) or it helps too deep already.
+         */
+        bool CanHelpCurrentWorker();
+        
+        /**
+         * @brief Executes one task of the worker running on the current thread while the thread waits for a result.
+         * @discussion The worker stays busy for its pool while helping.
+         * Helped tasks may help as well, but the nesting depth is limited so the stack can't grow unbounded.
+         * @return false if there is nothing to execute or the thread can't help.
+         */
+        bool HelpCurrentWorker();
+        
+        /**
+         * @brief Checks if the current thread executes tasks from 'HelpCurrentWorker'.
+         */
+        bool IsHelpingWorker();
     }
 }
 
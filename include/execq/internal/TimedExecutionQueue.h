@@ -0,0 +1,377 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/internal/ExecutionQueue.h"
+
+namespace execq
+{
+    namespace impl
+    {
+        enum class TimedMode
+        {
+            Debounce,
+            Throttle
+        };
+        
+        /**
+         * @brief Objects pushed within single debounce/throttle interval. Only the latest object is processed,
+         * its result is delivered to all the pushes.
+         */
+        template <typename T, typename R>
+        struct TimedBurst
+        {
+            ObjectPtr<T> object;
+            std::vector<std::promise<R>> promises;
+            std::vector<std::pair<std::shared_ptr<CompletionQueue<R>>, uint64_t>> completions;
+            bool isCanceled;
+        };
+        
+        template <typename T, typename R>
+        class TimedExecutionQueue: public IExecutionQueue<R(T)>
+        {
+        public:
+            TimedExecutionQueue(const TimedMode mode, const std::chrono::milliseconds interval,
+                                std::shared_ptr<IExecutionPool> executionPool,
+                                const IThreadWorkerFactory& workerFactory,
+                                MoveOnlyFunction<R(const std::atomic_bool& isCanceled, T&& object)> executor);
+            ~TimedExecutionQueue();
+            
+        public: // IExecutionQueue
+            virtual void cancel() final;
+            virtual void setAffinity(const uint64_t threadMask, const std::chrono::milliseconds spillThreshold) final;
+            virtual void rebind(std::shared_ptr<IExecutionPool> executionPool) final;
+            virtual void setPrefetch(std::function<void(const T& object)> prefetch) final;
+            virtual void setTarget(IExecutionTarget& target) final;
+            virtual void reserveRealtime(const size_t capacity) final;
+            virtual bool tryPushRealtime(T&& object) final;
+            
+        private: // IExecutionTarget
+            virtual IExecutionTargetProtocol& targetProtocol() final;
+            
+        private: // IExecutionQueue
+            virtual R dispatchSyncImpl(T& object) final;
+            virtual std::future<R> pushImpl(ObjectPtr<T> object) final;
+            virtual void pushImpl(ObjectPtr<T> object, std::shared_ptr<CompletionQueue<R>> completionQueue, const uint64_t tag) final;
+            
+        private:
+            void enqueue(ObjectPtr<T> object, std::promise<R>* promise,
+                         std::shared_ptr<CompletionQueue<R>> completionQueue, const uint64_t completionTag);
+            void onTimer();
+            void dispatchPending(const bool isCanceled = false);
+            
+            void execute(const std::atomic_bool& isCanceled, TimedBurst<T, R>&& burst, std::true_type /*voidResult*/);
+            void execute(const std::atomic_bool& isCanceled, TimedBurst<T, R>&& burst, std::false_type /*voidResult*/);
+            
+        private:
+            std::unique_ptr<TimedBurst<T, R>> m_pending;
+            Timer::TimerId m_timerId = 0;
+            std::chrono::steady_clock::time_point m_deadline;
+            std::chrono::steady_clock::time_point m_lastDispatch;
+            bool m_hasDispatched = false;
+            bool m_isShuttingDown = false;
+            std::mutex m_mutex;
+            
+            const std::atomic_bool m_canceledFlag { true };
+            const TimedMode m_mode;
+            const std::chrono::milliseconds m_interval;
+            const std::shared_ptr<IExecutionPool> m_timerPool;
+            const MoveOnlyFunction<R(const std::atomic_bool& isCanceled, T&& object)> m_executor;
+            
+            std::unique_ptr<ExecutionQueue<TimedBurst<T, R>, void>> m_queue;
+        };
+    }
+}
+
+template <typename T, typename R>
+execq::impl::TimedExecutionQueue<T, R>::TimedExecutionQueue(const TimedMode mode, const std::chrono::milliseconds interval,
+                                                            std::shared_ptr<IExecutionPool> executionPool,
+                                                            const IThreadWorkerFactory& workerFactory,
+                                                            MoveOnlyFunction<R(const std::atomic_bool& isCanceled, T&& object)> executor)
+: m_mode(mode)
+, m_interval(interval)
+, m_timerPool(executionPool)
+, m_executor(std::move(executor))
+, m_queue(new ExecutionQueue<TimedBurst<T, R>, void>(true, executionPool, workerFactory,
+                                                     [this] (const std::atomic_bool& isCanceled, TimedBurst<T, R>&& burst) {
+                                                         execute(isCanceled, std::move(burst), std::is_void<R>());
+                                                     }))
+{
+    if (!m_timerPool)
+    {
+        throw std::invalid_argument("Failed to create queue: execution pool is null.");
+    }
+}
+
+template <typename T, typename R>
+execq::impl::TimedExecutionQueue<T, R>::~TimedExecutionQueue()
+{
+    Timer::TimerId timerId = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isShuttingDown = true;
+        timerId = m_timerId;
+    }
+    
+    // Must be called without the lock: timer callback may be waiting for it.
+    if (timerId)
+    {
+        m_timerPool->timer().cancel(timerId);
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        dispatchPending(true);
+    }
+    
+    // Waits until all objects are processed. Pending ones are processed as canceled.
+    m_queue.reset();
+}
+
+// IExecutionQueue
+
+template <typename T, typename R>
+void execq::impl::TimedExecutionQueue<T, R>::cancel()
+{
+    // Pending objects are not waiting for the interval anymore and are processed as canceled.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    dispatchPending(true);
+    m_queue->cancel();
+}
+
+template <typename T, typename R>
+void execq::impl::TimedExecutionQueue<T, R>::setAffinity(const uint64_t threadMask, const std::chrono::milliseconds spillThreshold)
+{
+    m_queue->setAffinity(threadMask, spillThreshold);
+}
+
+template <typename T, typename R>
+void execq::impl::TimedExecutionQueue<T, R>::rebind(std::shared_ptr<IExecutionPool> executionPool)
+{
+    // Timers stay on the original pool: they only push objects into the queue.
+    m_queue->rebind(std::move(executionPool));
+}
+
+template <typename T, typename R>
+void execq::impl::TimedExecutionQueue<T, R>::setPrefetch(std::function<void(const T& object)> prefetch)
+{
+    if (!prefetch)
+    {
+        m_queue->setPrefetch(nullptr);
+        return;
+    }
+    
+    m_queue->setPrefetch([prefetch] (const TimedBurst<T, R>& burst) {
+        prefetch(*burst.object);
+    });
+}
+
+template <typename T, typename R>
+void execq::impl::TimedExecutionQueue<T, R>::setTarget(IExecutionTarget& target)
+{
+    m_queue->setTarget(target);
+}
+
+template <typename T, typename R>
+void execq::impl::TimedExecutionQueue<T, R>::reserveRealtime(const size_t)
+{
+    // Waiting for the interval requires the timer, that can't be scheduled without locking.
+}
+
+template <typename T, typename R>
+bool execq::impl::TimedExecutionQueue<T, R>::tryPushRealtime(T&&)
+{
+    return false;
+}
+
+// IExecutionTarget
+
+template <typename T, typename R>
+execq::impl::IExecutionTargetProtocol& execq::impl::TimedExecutionQueue<T, R>::targetProtocol()
+{
+    // Bursts are executed on the internal queue, so it is the one that is entered.
+    return TargetProtocol(*m_queue);
+}
+
+template <typename T, typename R>
+R execq::impl::TimedExecutionQueue<T, R>::dispatchSyncImpl(T& object)
+{
+    // Object always waits for the interval, so it is never processed inline.
+    std::future<R> future = pushImpl(ObjectPtr<T>(new UnownedObjectReleaser<T>(object)));
+    
+    // Pool thread doesn't just sleep: it executes other tasks (including the burst with the object) until the result is ready.
+    const bool canHelp = CanHelpCurrentWorker();
+    const std::chrono::milliseconds recheckInterval = std::max(m_interval, std::chrono::milliseconds(1));
+    while (canHelp && future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        if (!HelpCurrentWorker())
+        {
+            // Nothing to execute before the timer fires. The burst is guaranteed to be taken by the queue's additional worker anyway.
+            future.wait_for(recheckInterval);
+        }
+    }
+    
+    return future.get();
+}
+
+template <typename T, typename R>
+std::future<R> execq::impl::TimedExecutionQueue<T, R>::pushImpl(ObjectPtr<T> object)
+{
+    std::promise<R> promise;
+    std::future<R> future = promise.get_future();
+    
+    enqueue(std::move(object), &promise, nullptr, 0);
+    
+    return future;
+}
+
+template <typename T, typename R>
+void execq::impl::TimedExecutionQueue<T, R>::pushImpl(ObjectPtr<T> object, std::shared_ptr<CompletionQueue<R>> completionQueue, const uint64_t tag)
+{
+    if (!completionQueue)
+    {
+        throw std::invalid_argument("Failed to push object: completion queue is null.");
+    }
+    
+    enqueue(std::move(object), nullptr, std::move(completionQueue), tag);
+}
+
+// Private
+
+template <typename T, typename R>
+void execq::impl::TimedExecutionQueue<T, R>::enqueue(ObjectPtr<T> object, std::promise<R>* promise,
+                                                     std::shared_ptr<CompletionQueue<R>> completionQueue, const uint64_t completionTag)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    if (!m_pending)
+    {
+        m_pending.reset(new TimedBurst<T, R>());
+    }
+    
+    // The latest object wins, previous one is released right here.
+    m_pending->object = std::move(object);
+    if (promise)
+    {
+        m_pending->promises.push_back(std::move(*promise));
+    }
+    else
+    {
+        m_pending->completions.emplace_back(std::move(completionQueue), completionTag);
+    }
+    
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (m_mode == TimedMode::Debounce)
+    {
+        // The timer is not rescheduled on each push: when fired, it checks the deadline and re-arms itself.
+        m_deadline = now + m_interval;
+    }
+    else if (!m_timerId && (!m_hasDispatched || now >= m_lastDispatch + m_interval))
+    {
+        // Throttle: the first object in the window is processed immediately.
+        dispatchPending();
+        return;
+    }
+    else
+    {
+        m_deadline = m_lastDispatch + m_interval;
+    }
+    
+    if (!m_timerId)
+    {
+        m_timerId = m_timerPool->timer().schedule(m_deadline, [this] {
+            onTimer();
+        });
+    }
+}
+
+template <typename T, typename R>
+void execq::impl::TimedExecutionQueue<T, R>::onTimer()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_isShuttingDown)
+    {
+        return;
+    }
+    
+    m_timerId = 0;
+    if (m_mode == TimedMode::Debounce && std::chrono::steady_clock::now() < m_deadline)
+    {
+        m_timerId = m_timerPool->timer().schedule(m_deadline, [this] {
+            onTimer();
+        });
+        return;
+    }
+    
+    dispatchPending();
+}
+
+template <typename T, typename R>
+void execq::impl::TimedExecutionQueue<T, R>::dispatchPending(const bool isCanceled)
+{
+    if (!m_pending)
+    {
+        return;
+    }
+    
+    // Burst may start before the queue is canceled, so it carries the flag itself.
+    m_pending->isCanceled = isCanceled;
+    
+    m_hasDispatched = true;
+    m_lastDispatch = std::chrono::steady_clock::now();
+    
+    // Pushed under the lock to keep the order of bursts. Queue is serial, so bursts never overlap.
+    m_queue->push(std::move(m_pending));
+}
+
+template <typename T, typename R>
+void execq::impl::TimedExecutionQueue<T, R>::execute(const std::atomic_bool& isCanceled, TimedBurst<T, R>&& burst, std::true_type /*voidResult*/)
+{
+    m_executor(burst.isCanceled ? m_canceledFlag : isCanceled, std::move(*burst.object));
+    
+    for (auto& promise : burst.promises)
+    {
+        promise.set_value();
+    }
+    for (const auto& completion : burst.completions)
+    {
+        completion.first->post(completion.second);
+    }
+}
+
+template <typename T, typename R>
+void execq::impl::TimedExecutionQueue<T, R>::execute(const std::atomic_bool& isCanceled, TimedBurst<T, R>&& burst, std::false_type /*voidResult*/)
+{
+    const R result = m_executor(burst.isCanceled ? m_canceledFlag : isCanceled, std::move(*burst.object));
+    
+    for (auto& promise : burst.promises)
+    {
+        promise.set_value(result);
+    }
+    for (const auto& completion : burst.completions)
+    {
+        completion.first->post(completion.second, R(result));
+    }
+}
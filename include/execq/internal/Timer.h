@@ -0,0 +1,85 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace execq
+{
+    namespace impl
+    {
+        /**
+         * @brief Executes callbacks at specified time points.
+         * @discussion All timers share single thread that is created on the first 'schedule' call
+         * and waits until the nearest deadline. Callbacks are called on that thread,
+         * so they must be lightweight (i.e. push an object into the queue).
+         */
+        class Timer
+        {
+        public:
+            using TimerId = uint64_t;
+            
+            ~Timer();
+            
+            /**
+             * @return Identifier of the timer. Never zero.
+             */
+            TimerId schedule(const std::chrono::steady_clock::time_point deadline, std::function<void()> callback);
+            
+            /**
+             * @brief Removes the timer if it is not fired yet.
+             * @discussion If the callback is being called at the moment, waits until it returns
+             * (unless 'cancel' is called from the callback itself).
+             */
+            void cancel(const TimerId timerId);
+            
+        private:
+            using Deadline = std::pair<std::chrono::steady_clock::time_point, TimerId>;
+            
+            void threadMain();
+            
+        private:
+            std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> m_deadlines;
+            std::map<TimerId, std::function<void()>> m_callbacks;
+            TimerId m_nextTimerId = 1;
+            TimerId m_firingTimerId = 0;
+            
+            bool m_shouldQuit = false;
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            std::condition_variable m_firedCondition;
+            std::unique_ptr<std::thread> m_thread;
+        };
+    }
+}
@@ -0,0 +1,274 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "execq/ITopic.h"
+#include "execq/internal/ExecutionPool.h"
+
+#include <algorithm>
+#include <deque>
+#include <condition_variable>
+#include <stdexcept>
+
+namespace execq
+{
+    namespace impl
+    {
+        template <typename T>
+        class Subscriber;
+        
+        template <typename T>
+        class TopicState
+        {
+        public:
+            void publish(const std::shared_ptr<const T>& event);
+            
+            void addSubscriber(Subscriber<T>& subscriber);
+            void removeSubscriber(Subscriber<T>& subscriber);
+            
+        private:
+            std::vector<Subscriber<T>*> m_subscribers;
+            std::mutex m_mutex;
+        };
+        
+        template <typename T>
+        class Subscriber: public ISubscription, private ITaskProvider
+        {
+        public:
+            Subscriber(std::shared_ptr<TopicState<T>> topicState,
+                       std::shared_ptr<IExecutionPool> executionPool,
+                       const IThreadWorkerFactory& workerFactory,
+                       std::function<void(const std::atomic_bool& isCanceled, const T& event)> handler,
+                       const SubscriptionOptions& options);
+            ~Subscriber();
+            
+            void deliver(const std::shared_ptr<const T>& event);
+            
+        public: // ISubscription
+            virtual uint64_t droppedCount() const final;
+            
+        private: // ITaskProvider
+            virtual Task nextTask() final;
+            
+        private:
+            void notifyWorkers();
+            
+        private:
+            std::deque<std::shared_ptr<const T>> m_events;
+            size_t m_runningCount = 0;
+            std::atomic<uint64_t> m_droppedCount { 0 };
+            std::atomic_bool m_isCanceled { false };
+            std::mutex m_mutex;
+            std::condition_variable m_idleCondition;
+            
+            const SubscriptionOptions m_options;
+            const std::shared_ptr<TopicState<T>> m_topicState;
+            const std::shared_ptr<IExecutionPool> m_executionPool;
+            const std::function<void(const std::atomic_bool& isCanceled, const T& event)> m_handler;
+            
+            const std::unique_ptr<IThreadWorker> m_additionalWorker;
+        };
+        
+        template <typename T>
+        class Topic: public ITopic<T>
+        {
+        public:
+            Topic(std::shared_ptr<IExecutionPool> executionPool, std::shared_ptr<const IThreadWorkerFactory> workerFactory);
+            
+        public: // ITopic
+            virtual std::unique_ptr<ISubscription> subscribe(std::function<void(const std::atomic_bool& isCanceled, const T& event)> handler,
+                                                             const SubscriptionOptions& options) final;
+            
+        private: // ITopic
+            virtual void publishImpl(std::shared_ptr<const T> event) final;
+            
+        private:
+            const std::shared_ptr<TopicState<T>> m_state;
+            const std::shared_ptr<IExecutionPool> m_executionPool;
+            const std::shared_ptr<const IThreadWorkerFactory> m_workerFactory;
+        };
+    }
+}
+
+// TopicState
+
+template <typename T>
+void execq::impl::TopicState<T>::publish(const std::shared_ptr<const T>& event)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (Subscriber<T>* subscriber : m_subscribers)
+    {
+        subscriber->deliver(event);
+    }
+}
+
+template <typename T>
+void execq::impl::TopicState<T>::addSubscriber(Subscriber<T>& subscriber)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_subscribers.push_back(&subscriber);
+}
+
+template <typename T>
+void execq::impl::TopicState<T>::removeSubscriber(Subscriber<T>& subscriber)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_subscribers.erase(std::remove(m_subscribers.begin(), m_subscribers.end(), &subscriber), m_subscribers.end());
+}
+
+// Subscriber
+
+template <typename T>
+execq::impl::Subscriber<T>::Subscriber(std::shared_ptr<TopicState<T>> topicState,
+                                       std::shared_ptr<IExecutionPool> executionPool,
+                                       const IThreadWorkerFactory& workerFactory,
+                                       std::function<void(const std::atomic_bool& isCanceled, const T& event)> handler,
+                                       const SubscriptionOptions& options)
+: m_options(options)
+, m_topicState(topicState)
+, m_executionPool(executionPool)
+, m_handler(std::move(handler))
+, m_additionalWorker(workerFactory.createWorker(*this))
+{
+    m_executionPool->addProvider(*this);
+    m_topicState->addSubscriber(*this);
+}
+
+template <typename T>
+execq::impl::Subscriber<T>::~Subscriber()
+{
+    m_topicState->removeSubscriber(*this);
+    m_isCanceled = true;
+    
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this] { return m_events.empty() && !m_runningCount; });
+    lock.unlock();
+    
+    m_executionPool->removeProvider(*this);
+}
+
+template <typename T>
+void execq::impl::Subscriber<T>::deliver(const std::shared_ptr<const T>& event)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    
+    // Slow subscriber loses its oldest events instead of holding memory or the publisher.
+    if (m_options.maxLag && m_events.size() >= m_options.maxLag)
+    {
+        m_events.pop_front();
+        m_droppedCount++;
+    }
+    
+    m_events.push_back(event);
+    
+    const bool shouldNotify = !m_options.ordered || !m_runningCount;
+    lock.unlock();
+    
+    if (shouldNotify)
+    {
+        notifyWorkers();
+    }
+}
+
+// ISubscription
+
+template <typename T>
+uint64_t execq::impl::Subscriber<T>::droppedCount() const
+{
+    return m_droppedCount;
+}
+
+// ITaskProvider
+
+template <typename T>
+execq::impl::Task execq::impl::Subscriber<T>::nextTask()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_events.empty() || (m_options.ordered && m_runningCount))
+    {
+        return Task();
+    }
+    
+    const std::shared_ptr<const T> event = std::move(m_events.front());
+    m_events.pop_front();
+    m_runningCount++;
+    
+    return Task([this, event] {
+        m_handler(m_isCanceled, *event);
+        
+        // Subscriber can't be destroyed until the task is completely finished.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_runningCount--;
+        
+        if (m_options.ordered && !m_events.empty())
+        {
+            notifyWorkers();
+        }
+        else if (m_events.empty() && !m_runningCount)
+        {
+            m_idleCondition.notify_all();
+        }
+    });
+}
+
+// Private
+
+template <typename T>
+void execq::impl::Subscriber<T>::notifyWorkers()
+{
+    if (!m_executionPool->notifyOneWorker())
+    {
+        m_additionalWorker->notifyWorker();
+    }
+}
+
+// Topic
+
+template <typename T>
+execq::impl::Topic<T>::Topic(std::shared_ptr<IExecutionPool> executionPool, std::shared_ptr<const IThreadWorkerFactory> workerFactory)
+: m_state(std::make_shared<TopicState<T>>())
+, m_executionPool(executionPool)
+, m_workerFactory(workerFactory)
+{
+    if (!m_executionPool)
+    {
+        throw std::invalid_argument("Failed to create topic: execution pool is null.");
+    }
+}
+
+// ITopic
+
+template <typename T>
+std::unique_ptr<execq::ISubscription> execq::impl::Topic<T>::subscribe(std::function<void(const std::atomic_bool& isCanceled, const T& event)> handler,
+                                                                      const SubscriptionOptions& options)
+{
+    return std::unique_ptr<Subscriber<T>>(new Subscriber<T>(m_state, m_executionPool, *m_workerFactory, std::move(handler), options));
+}
+
+template <typename T>
+void execq::impl::Topic<T>::publishImpl(std::shared_ptr<const T> event)
+{
+    m_state->publish(event);
+}
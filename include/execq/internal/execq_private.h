@@ -25,6 +25,55 @@
 #pragma once
 
 #include "execq/internal/ExecutionQueue.h"
+#include "execq/internal/BatchExecutionQueue.h"
+#include "execq/internal/BarrierExecutionQueue.h"
+#include "execq/internal/OrderedExecutionQueue.h"
+#include "execq/internal/CoalescingExecutionQueue.h"
+#include "execq/internal/MemoizingExecutionQueue.h"
+#include "execq/internal/ChannelReceiver.h"
+#include "execq/internal/Actor.h"
+#include "execq/internal/TimedExecutionQueue.h"
+#include "execq/internal/Topic.h"
+#include "execq/internal/Pipeline.h"
+#include "execq/internal/MoveOnlyFunction.h"
+
+namespace execq
+{
+    namespace impl
+    {
+        std::unique_ptr<IExecutionStream> CreateExecutionStream(std::shared_ptr<IExecutionPool> executionPool,
+                                                                MoveOnlyFunction<void(const std::atomic_bool& isCanceled)> executee);
+    }
+}
+
+template <typename F>
+std::future<typename std::result_of<F()>::type> execq::Async(std::shared_ptr<IExecutionPool> executionPool, F&& function)
+{
+    std::packaged_task<typename std::result_of<F()>::type()> task(std::forward<F>(function));
+    auto future = task.get_future();
+    
+    executionPool->closureQueue().post(std::move(task));
+    
+    return future;
+}
+
+template <typename F>
+std::future<typename std::result_of<F()>::type> execq::Async(F&& function)
+{
+    return Async(DefaultExecutionPool(), std::forward<F>(function));
+}
+
+template <typename F>
+void execq::Post(std::shared_ptr<IExecutionPool> executionPool, F&& function)
+{
+    executionPool->closureQueue().post(std::forward<F>(function));
+}
+
+template <typename F>
+void execq::Post(F&& function)
+{
+    Post(DefaultExecutionPool(), std::forward<F>(function));
+}
 
 template <typename T, typename R>
 std::unique_ptr<execq::IExecutionQueue<R(T)>> execq::CreateConcurrentExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
@@ -36,11 +85,26 @@ std::unique_ptr<execq::IExecutionQueue<R(T)>> execq::CreateConcurrentExecutionQu
                                                                                       std::move(executor)));
 }
 
+template <typename T, typename R>
+std::unique_ptr<execq::IExecutionQueue<R(T)>> execq::CreateConcurrentExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                                    std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                                                                    std::function<size_t(const T& object)> localityKey,
+                                                                                    const size_t localityWindow)
+{
+    std::unique_ptr<impl::ExecutionQueue<T, R>> queue(new impl::ExecutionQueue<T, R>(false,
+                                                                                     executionPool,
+                                                                                     *impl::IThreadWorkerFactory::defaultFactory(),
+                                                                                     std::move(executor)));
+    queue->setLocalityKey(std::move(localityKey), localityWindow);
+    
+    return std::move(queue);
+}
+
 template <typename T, typename R>
 std::unique_ptr<execq::IExecutionQueue<R(T)>> execq::CreateSerialExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
                                                                                 std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor)
 {
-    return std::unique_ptr<impl::ExecutionQueue<T, R>>(new impl::ExecutionQueue<T, R>(false,
+    return std::unique_ptr<impl::ExecutionQueue<T, R>>(new impl::ExecutionQueue<T, R>(true,
                                                                                       executionPool,
                                                                                       *impl::IThreadWorkerFactory::defaultFactory(),
                                                                                       std::move(executor)));
@@ -54,3 +118,142 @@ std::unique_ptr<execq::IExecutionQueue<R(T)>> execq::CreateSerialExecutionQueue(
                                                                                       *impl::IThreadWorkerFactory::defaultFactory(),
                                                                                       std::move(executor)));
 }
+
+template <typename T, typename R, typename F>
+std::unique_ptr<execq::IExecutionQueue<R(T)>> execq::CreateConcurrentExecutionQueue(std::shared_ptr<IExecutionPool> executionPool, F&& executor)
+{
+    return std::unique_ptr<impl::ExecutionQueue<T, R>>(new impl::ExecutionQueue<T, R>(false,
+                                                                                      executionPool,
+                                                                                      *impl::IThreadWorkerFactory::defaultFactory(),
+                                                                                      std::forward<F>(executor)));
+}
+
+template <typename T, typename R, typename F>
+std::unique_ptr<execq::IExecutionQueue<R(T)>> execq::CreateSerialExecutionQueue(std::shared_ptr<IExecutionPool> executionPool, F&& executor)
+{
+    return std::unique_ptr<impl::ExecutionQueue<T, R>>(new impl::ExecutionQueue<T, R>(true,
+                                                                                      executionPool,
+                                                                                      *impl::IThreadWorkerFactory::defaultFactory(),
+                                                                                      std::forward<F>(executor)));
+}
+
+template <typename T, typename R, typename F>
+std::unique_ptr<execq::IExecutionQueue<R(T)>> execq::CreateSerialExecutionQueue(F&& executor)
+{
+    return std::unique_ptr<impl::ExecutionQueue<T, R>>(new impl::ExecutionQueue<T, R>(true,
+                                                                                      nullptr,
+                                                                                      *impl::IThreadWorkerFactory::defaultFactory(),
+                                                                                      std::forward<F>(executor)));
+}
+
+template <typename F>
+std::unique_ptr<execq::IExecutionStream> execq::CreateExecutionStream(std::shared_ptr<IExecutionPool> executionPool, F&& executee)
+{
+    return impl::CreateExecutionStream(executionPool, std::forward<F>(executee));
+}
+
+template <typename T, typename R>
+std::unique_ptr<execq::IOrderedExecutionQueue<T>> execq::CreateOrderedExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                                     const size_t reorderWindow,
+                                                                                     std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                                                                     typename impl::OrderedCompletion<R>::Type completion)
+{
+    return std::unique_ptr<impl::OrderedExecutionQueue<T, R>>(new impl::OrderedExecutionQueue<T, R>(executionPool,
+                                                                                                    *impl::IThreadWorkerFactory::defaultFactory(),
+                                                                                                    reorderWindow,
+                                                                                                    std::move(executor),
+                                                                                                    std::move(completion)));
+}
+
+template <typename K, typename T, typename R>
+std::unique_ptr<execq::ICoalescingExecutionQueue<R(T)>> execq::CreateCoalescingExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                                              std::function<K(const T& object)> keyExtractor,
+                                                                                              std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                                                                              std::function<void(T& pending, T&& object)> merge)
+{
+    return std::unique_ptr<impl::CoalescingExecutionQueue<K, T, R>>(new impl::CoalescingExecutionQueue<K, T, R>(executionPool,
+                                                                                                                *impl::IThreadWorkerFactory::defaultFactory(),
+                                                                                                                std::move(keyExtractor),
+                                                                                                                std::move(executor),
+                                                                                                                std::move(merge)));
+}
+
+template <typename K, typename T, typename R>
+std::unique_ptr<execq::IMemoizingExecutionQueue<R(T)>> execq::CreateMemoizingExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                                            std::function<K(const T& object)> keyExtractor,
+                                                                                            std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor,
+                                                                                            const size_t cacheCapacity,
+                                                                                            const std::chrono::milliseconds cacheTtl)
+{
+    return std::unique_ptr<impl::MemoizingExecutionQueue<K, T, R>>(new impl::MemoizingExecutionQueue<K, T, R>(executionPool,
+                                                                                                              *impl::IThreadWorkerFactory::defaultFactory(),
+                                                                                                              std::move(keyExtractor),
+                                                                                                              std::move(executor),
+                                                                                                              cacheCapacity,
+                                                                                                              cacheTtl));
+}
+
+template <typename T, typename R>
+std::unique_ptr<execq::IExecutionQueue<R(T)>> execq::CreateDebouncedExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                                   const std::chrono::milliseconds quietPeriod,
+                                                                                   std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor)
+{
+    return std::unique_ptr<impl::TimedExecutionQueue<T, R>>(new impl::TimedExecutionQueue<T, R>(impl::TimedMode::Debounce,
+                                                                                                quietPeriod,
+                                                                                                executionPool,
+                                                                                                *impl::IThreadWorkerFactory::defaultFactory(),
+                                                                                                std::move(executor)));
+}
+
+template <typename T, typename R>
+std::unique_ptr<execq::IExecutionQueue<R(T)>> execq::CreateThrottledExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                                   const std::chrono::milliseconds window,
+                                                                                   std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor)
+{
+    return std::unique_ptr<impl::TimedExecutionQueue<T, R>>(new impl::TimedExecutionQueue<T, R>(impl::TimedMode::Throttle,
+                                                                                                window,
+                                                                                                executionPool,
+                                                                                                *impl::IThreadWorkerFactory::defaultFactory(),
+                                                                                                std::move(executor)));
+}
+
+template <typename T>
+std::unique_ptr<execq::IBatchExecutionQueue<T>> execq::CreateBatchExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                                 const size_t batchSize,
+                                                                                 std::function<void(const std::atomic_bool& isCanceled, ObjectBatch<T> batch)> executor)
+{
+    return std::unique_ptr<impl::BatchExecutionQueue<T>>(new impl::BatchExecutionQueue<T>(executionPool,
+                                                                                          *impl::IThreadWorkerFactory::defaultFactory(),
+                                                                                          batchSize,
+                                                                                          std::move(executor)));
+}
+
+template <typename T>
+std::unique_ptr<execq::ITopic<T>> execq::CreateTopic(std::shared_ptr<IExecutionPool> executionPool)
+{
+    return std::unique_ptr<impl::Topic<T>>(new impl::Topic<T>(executionPool, impl::IThreadWorkerFactory::defaultFactory()));
+}
+
+template <typename T>
+std::unique_ptr<execq::IChannelReceiver> execq::CreateChannelReceiver(std::shared_ptr<IExecutionPool> executionPool,
+                                                                      std::shared_ptr<Channel<T>> channel,
+                                                                      std::function<void(const std::atomic_bool& isCanceled, T&& value)> handler)
+{
+    return std::unique_ptr<impl::ChannelReceiver<T>>(new impl::ChannelReceiver<T>(executionPool, *impl::IThreadWorkerFactory::defaultFactory(), channel, std::move(handler)));
+}
+
+template <typename M>
+std::unique_ptr<execq::IActor<M>> execq::CreateActor(std::shared_ptr<IActorSystem> actorSystem,
+                                                     std::function<void(const std::atomic_bool& isCanceled, M&& message)> handler)
+{
+    return std::unique_ptr<impl::Actor<M>>(new impl::Actor<M>(actorSystem, std::move(handler)));
+}
+
+template <typename T, typename R>
+std::unique_ptr<execq::IBarrierExecutionQueue<R(T)>> execq::CreateBarrierExecutionQueue(std::shared_ptr<IExecutionPool> executionPool,
+                                                                                        std::function<R(const std::atomic_bool& isCanceled, T&& object)> executor)
+{
+    return std::unique_ptr<impl::BarrierExecutionQueue<T, R>>(new impl::BarrierExecutionQueue<T, R>(executionPool,
+                                                                                                  *impl::IThreadWorkerFactory::defaultFactory(),
+                                                                                                  std::move(executor)));
+}
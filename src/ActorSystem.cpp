@@ -0,0 +1,234 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ActorSystem.h"
+
+#include <stdexcept>
+#include <thread>
+
+// Mailbox
+
+execq::impl::Mailbox::Mailbox()
+: m_head(&m_stub)
+, m_tail(&m_stub)
+{}
+
+void execq::impl::Mailbox::push(MailboxNode* node)
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    MailboxNode* const previous = m_head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+execq::impl::MailboxNode* execq::impl::Mailbox::pop()
+{
+    MailboxNode* tail = m_tail;
+    MailboxNode* next = tail->next.load(std::memory_order_acquire);
+    
+    if (tail == &m_stub)
+    {
+        if (!next)
+        {
+            return nullptr;
+        }
+        
+        m_tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    
+    if (next)
+    {
+        m_tail = next;
+        return tail;
+    }
+    
+    if (tail != m_head.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+    
+    // The last node can't be taken until something follows it.
+    push(&m_stub);
+    
+    next = tail->next.load(std::memory_order_acquire);
+    if (next)
+    {
+        m_tail = next;
+        return tail;
+    }
+    
+    return nullptr;
+}
+
+// ActorCore
+
+bool execq::impl::ActorCore::activate(const size_t messageBudget)
+{
+    size_t processedCount = 0;
+    while (processedCount < messageBudget && processedCount < m_pendingCount.load(std::memory_order_acquire))
+    {
+        MailboxNode* const message = m_mailbox.pop();
+        if (!message)
+        {
+            // The message is counted, but its sender has not linked it into the mailbox yet.
+            std::this_thread::yield();
+            continue;
+        }
+        
+        handle(message);
+        processedCount++;
+    }
+    
+    // Actor may be destroyed as soon as the count drops to zero: no members are accessed after.
+    return m_pendingCount.fetch_sub(processedCount, std::memory_order_acq_rel) != processedCount;
+}
+
+bool execq::impl::ActorCore::isIdle() const
+{
+    return !m_pendingCount.load(std::memory_order_acquire);
+}
+
+bool execq::impl::ActorCore::post(MailboxNode* message)
+{
+    m_mailbox.push(message);
+    return !m_pendingCount.fetch_add(1, std::memory_order_acq_rel);
+}
+
+// ActorSystem
+
+execq::impl::ActorSystem::ActorSystem(std::shared_ptr<IExecutionPool> executionPool,
+                                      const IThreadWorkerFactory& workerFactory,
+                                      const size_t messageBudget)
+: m_messageBudget(messageBudget)
+, m_executionPool(executionPool)
+, m_additionalWorker(workerFactory.createWorker(*this))
+{
+    if (!m_executionPool)
+    {
+        throw std::invalid_argument("Failed to create IActorSystem: execution pool is null.");
+    }
+    
+    m_executionPool->addProvider(*this);
+}
+
+execq::impl::ActorSystem::~ActorSystem()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this] { return !m_activeCount && !m_runQueueHead; });
+    lock.unlock();
+    
+    m_executionPool->removeProvider(*this);
+}
+
+// IActorSystem
+
+execq::impl::IActorScheduler& execq::impl::ActorSystem::actorScheduler()
+{
+    return *this;
+}
+
+// IActorScheduler
+
+void execq::impl::ActorSystem::schedule(ActorCore& actor)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    enqueue(actor);
+    lock.unlock();
+    
+    notifyWorkers();
+}
+
+void execq::impl::ActorSystem::waitIdle(const ActorCore& actor)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleWaitersCount++;
+    m_idleCondition.wait(lock, [&actor] { return actor.isIdle(); });
+    m_idleWaitersCount--;
+}
+
+// ITaskProvider
+
+execq::impl::Task execq::impl::ActorSystem::nextTask()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ActorCore* const actor = m_runQueueHead;
+    if (!actor)
+    {
+        return Task();
+    }
+    
+    m_runQueueHead = actor->m_nextScheduled;
+    if (!m_runQueueHead)
+    {
+        m_runQueueTail = nullptr;
+    }
+    actor->m_nextScheduled = nullptr;
+    m_activeCount++;
+    
+    return Task([this, actor] {
+        const bool hasMoreMessages = actor->activate(m_messageBudget);
+        
+        // Actor that used up its budget goes to the end of the run queue to let others run.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_activeCount--;
+        if (hasMoreMessages)
+        {
+            enqueue(*actor);
+        }
+        
+        if (hasMoreMessages)
+        {
+            notifyWorkers();
+        }
+        
+        if (m_idleWaitersCount || !m_activeCount)
+        {
+            m_idleCondition.notify_all();
+        }
+    });
+}
+
+// Private
+
+void execq::impl::ActorSystem::enqueue(ActorCore& actor)
+{
+    if (m_runQueueTail)
+    {
+        m_runQueueTail->m_nextScheduled = &actor;
+    }
+    else
+    {
+        m_runQueueHead = &actor;
+    }
+    m_runQueueTail = &actor;
+}
+
+void execq::impl::ActorSystem::notifyWorkers()
+{
+    if (!m_executionPool->notifyOneWorker())
+    {
+        m_additionalWorker->notifyWorker();
+    }
+}
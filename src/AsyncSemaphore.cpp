@@ -0,0 +1,144 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "AsyncSemaphore.h"
+
+#include <stdexcept>
+
+execq::impl::AsyncSemaphore::AsyncSemaphore(const size_t permitCount,
+                                            std::shared_ptr<IExecutionPool> executionPool,
+                                            const IThreadWorkerFactory& workerFactory)
+: m_availableCount(permitCount)
+, m_permitCount(permitCount)
+, m_executionPool(executionPool)
+, m_additionalWorker(workerFactory.createWorker(*this))
+{
+    if (!m_executionPool)
+    {
+        throw std::invalid_argument("Failed to create IAsyncSemaphore: execution pool is null.");
+    }
+    
+    m_executionPool->addProvider(*this);
+}
+
+execq::impl::AsyncSemaphore::~AsyncSemaphore()
+{
+    // Continuations still waiting get their permits in turn, but as canceled.
+    m_isCanceled = true;
+    
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this] { return isIdle(); });
+    lock.unlock();
+    
+    m_executionPool->removeProvider(*this);
+}
+
+// IAsyncSemaphore
+
+void execq::impl::AsyncSemaphore::acquire(Continuation continuation)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_availableCount || !m_waiting.empty())
+    {
+        m_waiting.push_back(std::move(continuation));
+        return;
+    }
+    
+    m_availableCount--;
+    m_granted.push_back(std::move(continuation));
+    notifyWorkers();
+}
+
+execq::AsyncPermit execq::impl::AsyncSemaphore::tryAcquire()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_availableCount || !m_waiting.empty())
+    {
+        return AsyncPermit();
+    }
+    
+    m_availableCount--;
+    return AsyncPermit(*this);
+}
+
+void execq::impl::AsyncSemaphore::releasePermit()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_waiting.empty())
+    {
+        m_availableCount++;
+        if (isIdle())
+        {
+            m_idleCondition.notify_all();
+        }
+        return;
+    }
+    
+    // The permit is handed over to the next waiting continuation directly.
+    m_granted.push_back(std::move(m_waiting.front()));
+    m_waiting.pop_front();
+    notifyWorkers();
+}
+
+// ITaskProvider
+
+execq::impl::Task execq::impl::AsyncSemaphore::nextTask()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_granted.empty())
+    {
+        return Task();
+    }
+    
+    const std::shared_ptr<Continuation> continuation = std::make_shared<Continuation>(std::move(m_granted.front()));
+    m_granted.pop_front();
+    m_runningCount++;
+    
+    return Task([this, continuation] {
+        (*continuation)(m_isCanceled, AsyncPermit(*this));
+        
+        // Semaphore can't be destroyed until the task is completely finished.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_runningCount--;
+        if (isIdle())
+        {
+            m_idleCondition.notify_all();
+        }
+    });
+}
+
+// Private
+
+bool execq::impl::AsyncSemaphore::isIdle() const
+{
+    return m_waiting.empty() && m_granted.empty() && !m_runningCount && m_availableCount == m_permitCount;
+}
+
+void execq::impl::AsyncSemaphore::notifyWorkers()
+{
+    if (!m_executionPool->notifyOneWorker())
+    {
+        m_additionalWorker->notifyWorker();
+    }
+}
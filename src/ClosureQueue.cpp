@@ -0,0 +1,107 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ClosureQueue.h"
+#include "ExecutionPool.h"
+
+execq::impl::ClosureQueue::ClosureQueue(IExecutionPool& executionPool, const IThreadWorkerFactory& workerFactory)
+: m_executionPool(executionPool)
+, m_additionalWorker(workerFactory.createWorker(*this))
+{
+    m_executionPool.addProvider(*this);
+}
+
+execq::impl::ClosureQueue::~ClosureQueue()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this] { return !m_runningCount && m_closures.empty(); });
+    lock.unlock();
+    
+    m_executionPool.removeProvider(*this);
+}
+
+void execq::impl::ClosureQueue::post(Closure closure)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closures.push_back(std::move(closure));
+        m_hasClosures = true;
+    }
+    
+    notifyWorkers();
+}
+
+// ITaskProvider
+
+execq::impl::Task execq::impl::ClosureQueue::nextTask()
+{
+    if (!m_hasClosures)
+    {
+        return Task();
+    }
+    
+    std::shared_ptr<Closure> closure;
+    {
+        // Closure is claimed right here: workers polling concurrently never get empty tasks.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_closures.empty())
+        {
+            return Task();
+        }
+        
+        closure = std::make_shared<Closure>(std::move(m_closures.front()));
+        m_closures.pop_front();
+        m_hasClosures = !m_closures.empty();
+        m_runningCount++;
+    }
+    
+    return Task([this, closure] {
+        // 'Async' closures report exceptions through the future, 'Post' ones have nobody to report to.
+        try
+        {
+            (*closure)();
+        }
+        catch (...)
+        {}
+        
+        // Closure is destroyed before the queue is allowed to be destroyed.
+        *closure = Closure();
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!--m_runningCount && m_closures.empty())
+        {
+            m_idleCondition.notify_all();
+        }
+    });
+}
+
+// Private
+
+void execq::impl::ClosureQueue::notifyWorkers()
+{
+    if (!m_executionPool.notifyOneWorker())
+    {
+        m_additionalWorker->notifyWorker();
+    }
+}
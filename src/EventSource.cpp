@@ -0,0 +1,117 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "EventSource.h"
+
+#include <stdexcept>
+
+execq::impl::EventSource::EventSource(const EventMerge merge,
+                                      std::shared_ptr<IExecutionPool> executionPool,
+                                      const IThreadWorkerFactory& workerFactory,
+                                      std::function<void(const std::atomic_bool& isCanceled, const uint64_t value)> handler)
+: m_merge(merge)
+, m_executionPool(executionPool)
+, m_handler(std::move(handler))
+, m_additionalWorker(workerFactory.createWorker(*this))
+{
+    if (!m_executionPool)
+    {
+        throw std::invalid_argument("Failed to create IEventSource: execution pool is null.");
+    }
+    
+    m_executionPool->addProvider(*this);
+}
+
+execq::impl::EventSource::~EventSource()
+{
+    // Value accumulated so far is delivered to the handler as canceled.
+    m_isCanceled = true;
+    
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this] { return !m_isRunning && !m_accumulator; });
+    lock.unlock();
+    
+    m_executionPool->removeProvider(*this);
+}
+
+// IEventSource
+
+void execq::impl::EventSource::signal(const uint64_t value)
+{
+    const uint64_t previous = m_merge == EventMerge::Add ? m_accumulator.fetch_add(value) : m_accumulator.fetch_or(value);
+    
+    // Only the signal that makes the accumulator non-empty schedules the handler.
+    if (!previous && value)
+    {
+        notifyWorkers();
+    }
+}
+
+// ITaskProvider
+
+execq::impl::Task execq::impl::EventSource::nextTask()
+{
+    if (!m_accumulator)
+    {
+        return Task();
+    }
+    
+    bool isRunning = false;
+    if (!m_isRunning.compare_exchange_strong(isRunning, true))
+    {
+        return Task();
+    }
+    
+    return Task([this] {
+        const uint64_t value = m_accumulator.exchange(0);
+        if (value)
+        {
+            m_handler(m_isCanceled, value);
+        }
+        
+        // Source can't be destroyed until the task is completely finished.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isRunning = false;
+        
+        // Signals that came during the handler could not schedule it.
+        if (m_accumulator)
+        {
+            notifyWorkers();
+        }
+        else
+        {
+            m_idleCondition.notify_all();
+        }
+    });
+}
+
+// Private
+
+void execq::impl::EventSource::notifyWorkers()
+{
+    if (!m_executionPool->notifyOneWorker())
+    {
+        m_additionalWorker->notifyWorker();
+    }
+}
@@ -24,11 +24,22 @@
 
 #include "ExecutionPool.h"
 
+namespace
+{
+    int64_t Now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
 execq::impl::ExecutionPool::ExecutionPool(const uint32_t threadCount, const IThreadWorkerFactory& workerFactory)
+: m_workersBusySince(new std::atomic<int64_t>[threadCount])
 {
     for (uint32_t i = 0; i < threadCount; i++)
     {
-        m_workers.emplace_back(workerFactory.createWorker(m_providerGroup));
+        m_workersBusySince[i] = 0;
+        m_workerSlots.emplace_back(new WorkerSlot(*this, i));
+        m_workers.emplace_back(workerFactory.createWorker(*m_workerSlots.back()));
     }
 }
 
@@ -52,6 +63,155 @@ void execq::impl::ExecutionPool::notifyAllWorkers()
     details::NotifyWorkers(m_workers, false);
 }
 
+bool execq::impl::ExecutionPool::notifyOneWorker(const TaskAffinity& affinity)
+{
+    if (!affinity.isRestricted())
+    {
+        return notifyOneWorker();
+    }
+    
+    // Workers out of the mask refuse the task while any preferred worker is idle, so the idle one must be woken up.
+    bool hasPreferredWorker = false;
+    bool hasIdlePreferredWorker = false;
+    for (size_t i = 0; i < m_workers.size(); i++)
+    {
+        if (!affinity.allowsThread(i))
+        {
+            continue;
+        }
+        
+        hasPreferredWorker = true;
+        if (!m_workersBusySince[i])
+        {
+            if (m_workers[i]->notifyWorker())
+            {
+                return true;
+            }
+            
+            // Already notified: the worker checks for the next task anyway.
+            hasIdlePreferredWorker = true;
+        }
+    }
+    
+    if (!hasPreferredWorker)
+    {
+        // Mask doesn't match any worker of the pool, so it doesn't restrict anything.
+        return notifyOneWorker();
+    }
+    
+    if (hasIdlePreferredWorker)
+    {
+        return true;
+    }
+    
+    // All preferred workers are busy: other workers may take the task once they are busy long enough.
+    // Task is released only by the spill check, so the caller must not execute it out of the mask right away.
+    scheduleSpillCheck(affinity.spillThreshold());
+    
+    return true;
+}
+
+execq::impl::Timer& execq::impl::ExecutionPool::timer()
+{
+    return m_timer;
+}
+
+execq::impl::ClosureQueue& execq::impl::ExecutionPool::closureQueue()
+{
+    // Most pools never run ad-hoc closures, so the queue is not registered in advance.
+    std::call_once(m_closureQueueOnce, [this] {
+        m_closureQueue.reset(new ClosureQueue(*this, *IThreadWorkerFactory::defaultFactory()));
+    });
+    
+    return *m_closureQueue;
+}
+
+// Private
+
+execq::impl::ExecutionPool::WorkerSlot::WorkerSlot(ExecutionPool& pool, const size_t index)
+: m_pool(pool)
+, m_index(index)
+{}
+
+execq::impl::Task execq::impl::ExecutionPool::WorkerSlot::nextTask()
+{
+    return m_pool.nextTask(m_index);
+}
+
+execq::impl::Task execq::impl::ExecutionPool::nextTask(const size_t workerIndex)
+{
+    // Helping worker still waits for its own task, so it stays busy whatever it finds.
+    const bool isHelping = IsHelpingWorker();
+    
+    // Otherwise worker asks for the next task only when it is done with previous one.
+    if (!isHelping)
+    {
+        m_workersBusySince[workerIndex] = 0;
+    }
+    
+    Task task = m_providerGroup.nextTask([this, workerIndex] (const ITaskProvider& provider) {
+        return isAllowedOnWorker(provider, workerIndex);
+    });
+    if (task.valid() && !isHelping)
+    {
+        m_workersBusySince[workerIndex] = Now();
+    }
+    
+    return task;
+}
+
+bool execq::impl::ExecutionPool::isAllowedOnWorker(const ITaskProvider& provider, const size_t workerIndex) const
+{
+    const TaskAffinity* affinity = provider.affinity();
+    if (!affinity || affinity->allowsThread(workerIndex))
+    {
+        return true;
+    }
+    
+    // Worker is out of provider's mask. Take the task only if all preferred workers are busy for too long.
+    const int64_t now = Now();
+    const int64_t spillThreshold = affinity->spillThreshold().count();
+    for (size_t i = 0; i < m_workers.size(); i++)
+    {
+        if (!affinity->allowsThread(i))
+        {
+            continue;
+        }
+        
+        const int64_t busySince = m_workersBusySince[i];
+        if (!busySince || now - busySince < spillThreshold)
+        {
+            return false;
+        }
+    }
+    
+    // All preferred workers are busy for too long (or mask doesn't match any worker of the pool).
+    return true;
+}
+
+void execq::impl::ExecutionPool::scheduleSpillCheck(const std::chrono::nanoseconds spillThreshold)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(spillThreshold);
+    const int64_t deadlineNs = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    
+    // Single pending check is enough unless it fires later than this one: it wakes up all the workers.
+    int64_t pendingDeadline = m_spillCheckDeadline;
+    do
+    {
+        if (pendingDeadline && pendingDeadline <= deadlineNs)
+        {
+            return;
+        }
+    } while (!m_spillCheckDeadline.compare_exchange_weak(pendingDeadline, deadlineNs));
+    
+    m_timer.schedule(deadline, [this, deadlineNs] {
+        // Replaced check fires as well, but it must not reset the pending one.
+        int64_t ownDeadline = deadlineNs;
+        m_spillCheckDeadline.compare_exchange_strong(ownDeadline, 0);
+        notifyAllWorkers();
+    });
+}
+
 // Details
 
 bool execq::impl::details::NotifyWorkers(const std::vector<std::unique_ptr<IThreadWorker>>& workers, const bool single)
@@ -26,7 +26,7 @@
 
 execq::impl::ExecutionStream::ExecutionStream(std::shared_ptr<IExecutionPool> executionPool,
                                               const IThreadWorkerFactory& workerFactory,
-                                              std::function<void(const std::atomic_bool& isCanceled)> executee)
+                                              MoveOnlyFunction<void(const std::atomic_bool& isCanceled)> executee)
 : m_executionPool(executionPool)
 , m_executee(std::move(executee))
 , m_additionalWorker(workerFactory.createWorker(*this))
@@ -46,7 +46,15 @@ execq::impl::ExecutionStream::~ExecutionStream()
 void execq::impl::ExecutionStream::start()
 {
     m_stopped = false;
-    m_executionPool->notifyAllWorkers();
+    if (m_affinity.isRestricted())
+    {
+        // Workers out of the mask refuse the stream until the spill check: each started task wakes up the next worker.
+        m_executionPool->notifyOneWorker(m_affinity);
+    }
+    else
+    {
+        m_executionPool->notifyAllWorkers();
+    }
     m_additionalWorker->notifyWorker();
 }
 
@@ -55,6 +63,11 @@ void execq::impl::ExecutionStream::stop()
     m_stopped = true;
 }
 
+void execq::impl::ExecutionStream::setAffinity(const uint64_t threadMask, const std::chrono::milliseconds spillThreshold)
+{
+    m_affinity.set(threadMask, spillThreshold);
+}
+
 // IThreadWorkerPoolTaskProvider
 
 execq::impl::Task execq::impl::ExecutionStream::nextTask()
@@ -66,6 +79,12 @@ execq::impl::Task execq::impl::ExecutionStream::nextTask()
     
     m_tasksRunningCount++;
     return Task([&] {
+        if (m_affinity.isRestricted() && !m_stopped)
+        {
+            // Current worker is busy now: wake up idle preferred worker or schedule the spill check.
+            m_executionPool->notifyOneWorker(m_affinity);
+        }
+        
         m_executee(m_stopped);
         m_tasksRunningCount--;
         
@@ -76,6 +95,11 @@ execq::impl::Task execq::impl::ExecutionStream::nextTask()
     });
 }
 
+const execq::impl::TaskAffinity* execq::impl::ExecutionStream::affinity() const
+{
+    return &m_affinity;
+}
+
 // Private
 
 void execq::impl::ExecutionStream::waitPendingTasks()
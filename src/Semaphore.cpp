@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Semaphore.h"
+
+#include <stdexcept>
+
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#include <climits>
+#else
+#include <cerrno>
+#include <semaphore.h>
+#endif
+
+#if defined(__APPLE__)
+
+// Unnamed POSIX semaphores are not supported on macOS.
+struct execq::impl::Semaphore::Native
+{
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    
+    ~Native() { dispatch_release(semaphore); }
+    void signal() { dispatch_semaphore_signal(semaphore); }
+    void wait() { dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER); }
+};
+
+#elif defined(_WIN32)
+
+struct execq::impl::Semaphore::Native
+{
+    HANDLE semaphore = CreateSemaphore(nullptr, 0, LONG_MAX, nullptr);
+    
+    ~Native() { CloseHandle(semaphore); }
+    void signal() { ReleaseSemaphore(semaphore, 1, nullptr); }
+    void wait() { WaitForSingleObject(semaphore, INFINITE); }
+};
+
+#else
+
+struct execq::impl::Semaphore::Native
+{
+    sem_t semaphore;
+    
+    Native()
+    {
+        if (sem_init(&semaphore, 0, 0) != 0)
+        {
+            throw std::runtime_error("Failed to create Semaphore: sem_init failed.");
+        }
+    }
+    
+    ~Native() { sem_destroy(&semaphore); }
+    void signal() { sem_post(&semaphore); }
+    
+    void wait()
+    {
+        // Interrupted by a signal handler: the semaphore is not acquired yet.
+        while (sem_wait(&semaphore) != 0 && errno == EINTR)
+        {}
+    }
+};
+
+#endif
+
+execq::impl::Semaphore::Semaphore()
+: m_native(new Native())
+{}
+
+execq::impl::Semaphore::~Semaphore() = default;
+
+void execq::impl::Semaphore::signal()
+{
+    m_native->signal();
+}
+
+void execq::impl::Semaphore::wait()
+{
+    m_native->wait();
+}
@@ -0,0 +1,57 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "TaskAffinity.h"
+
+void execq::impl::TaskAffinity::set(const uint64_t threadMask, const std::chrono::nanoseconds spillThreshold)
+{
+    m_spillThreshold = spillThreshold.count();
+    m_threadMask = threadMask;
+}
+
+bool execq::impl::TaskAffinity::isRestricted() const
+{
+    return m_threadMask != 0;
+}
+
+bool execq::impl::TaskAffinity::allowsThread(const size_t threadIndex) const
+{
+    const uint64_t mask = m_threadMask;
+    if (!mask || threadIndex >= 64)
+    {
+        return !mask;
+    }
+    
+    return (mask >> threadIndex) & 1;
+}
+
+uint64_t execq::impl::TaskAffinity::threadMask() const
+{
+    return m_threadMask;
+}
+
+std::chrono::nanoseconds execq::impl::TaskAffinity::spillThreshold() const
+{
+    return std::chrono::nanoseconds(m_spillThreshold.load());
+}
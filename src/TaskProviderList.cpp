@@ -24,7 +24,14 @@
 
 #include "TaskProviderList.h"
 
+#include <algorithm>
+
 execq::impl::Task execq::impl::TaskProviderList::nextTask()
+{
+    return nextTask(nullptr);
+}
+
+execq::impl::Task execq::impl::TaskProviderList::nextTask(const ProviderFilter& filter)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     
@@ -39,6 +46,11 @@ execq::impl::Task execq::impl::TaskProviderList::nextTask()
         }
         
         ITaskProvider* const provider = *(m_currentTaskProviderIt++);
+        if (filter && !filter(*provider))
+        {
+            continue;
+        }
+        
         Task task = provider->nextTask();
         if (task.valid())
         {
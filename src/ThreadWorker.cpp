@@ -23,6 +23,7 @@
  */
 
 #include "ThreadWorker.h"
+#include "Semaphore.h"
 
 namespace execq
 {
@@ -35,14 +36,19 @@ namespace execq
             virtual ~ThreadWorker();
             
             virtual bool notifyWorker() final;
+            virtual void enableSignals() final;
+            virtual void signalWorker() final;
             
         private:
             void threadMain();
             void shutdown();
+            void wakeUp();
             
         private:
             std::atomic_bool m_shouldQuit { false };
             std::atomic_bool m_checkNextTask { false };
+            std::atomic_bool m_acceptsSignals { false };
+            std::unique_ptr<Semaphore> m_signalSemaphore;
             std::condition_variable m_condition;
             std::mutex m_mutex;
             std::unique_ptr<std::thread> m_thread;
@@ -52,6 +58,67 @@ namespace execq
     }
 }
 
+namespace
+{
+    thread_local execq::impl::ITaskProvider* t_currentWorkerProvider = nullptr;
+    thread_local size_t t_helpDepth = 0;
+    thread_local size_t t_exclusiveTaskDepth = 0;
+    
+    const size_t kMaxHelpDepth = 4;
+    
+    class HelpDepthGuard
+    {
+    public:
+        HelpDepthGuard() { t_helpDepth++; }
+        ~HelpDepthGuard() { t_helpDepth--; }
+    };
+}
+
+execq::impl::ExclusiveTaskGuard::ExclusiveTaskGuard(const bool isExclusive)
+: m_isExclusive(isExclusive)
+{
+    if (m_isExclusive)
+    {
+        t_exclusiveTaskDepth++;
+    }
+}
+
+execq::impl::ExclusiveTaskGuard::~ExclusiveTaskGuard()
+{
+    if (m_isExclusive)
+    {
+        t_exclusiveTaskDepth--;
+    }
+}
+
+bool execq::impl::CanHelpCurrentWorker()
+{
+    return t_currentWorkerProvider && !t_exclusiveTaskDepth && t_helpDepth < kMaxHelpDepth;
+}
+
+bool execq::impl::HelpCurrentWorker()
+{
+    if (!CanHelpCurrentWorker())
+    {
+        return false;
+    }
+    
+    const HelpDepthGuard guard;
+    Task task = t_currentWorkerProvider->nextTask();
+    if (!task.valid())
+    {
+        return false;
+    }
+    
+    task();
+    return true;
+}
+
+bool execq::impl::IsHelpingWorker()
+{
+    return t_helpDepth > 0;
+}
+
 std::shared_ptr<const execq::impl::IThreadWorkerFactory> execq::impl::IThreadWorkerFactory::defaultFactory()
 {
     class ThreadWorkerFactory: public IThreadWorkerFactory
@@ -94,20 +161,61 @@ bool execq::impl::ThreadWorker::notifyWorker()
         m_thread.reset(new std::thread(&ThreadWorker::threadMain, this));
     }
     
-    m_condition.notify_one();
+    wakeUp();
     
     return true;
 }
 
+void execq::impl::ThreadWorker::enableSignals()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_acceptsSignals)
+    {
+        return;
+    }
+    
+    m_signalSemaphore.reset(new Semaphore());
+    m_acceptsSignals = true;
+    if (!m_thread)
+    {
+        m_thread.reset(new std::thread(&ThreadWorker::threadMain, this));
+    }
+    
+    // Worker that already sleeps on the condition moves to the semaphore.
+    m_condition.notify_one();
+}
+
+void execq::impl::ThreadWorker::signalWorker()
+{
+    if (!m_checkNextTask.exchange(true))
+    {
+        m_signalSemaphore->signal();
+    }
+}
+
 void execq::impl::ThreadWorker::shutdown()
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     m_shouldQuit = true;
-    m_condition.notify_one();
+    wakeUp();
+}
+
+void execq::impl::ThreadWorker::wakeUp()
+{
+    if (m_acceptsSignals)
+    {
+        m_signalSemaphore->signal();
+    }
+    else
+    {
+        m_condition.notify_one();
+    }
 }
 
 void execq::impl::ThreadWorker::threadMain()
 {
+    t_currentWorkerProvider = &m_provider;
+    
     while (true)
     {
         if (m_shouldQuit)
@@ -134,6 +242,15 @@ void execq::impl::ThreadWorker::threadMain()
             break;
         }
         
-        m_condition.wait(lock);
+        if (m_acceptsSignals)
+        {
+            // Signals are sent without the mutex. Semaphore counts them, so the one sent right now is not lost.
+            lock.unlock();
+            m_signalSemaphore->wait();
+        }
+        else
+        {
+            m_condition.wait(lock);
+        }
     }
 }
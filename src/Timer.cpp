@@ -0,0 +1,118 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Timer.h"
+
+execq::impl::Timer::~Timer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shouldQuit = true;
+        m_condition.notify_one();
+    }
+    
+    if (m_thread && m_thread->joinable())
+    {
+        m_thread->join();
+    }
+}
+
+execq::impl::Timer::TimerId execq::impl::Timer::schedule(const std::chrono::steady_clock::time_point deadline, std::function<void()> callback)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    const TimerId timerId = m_nextTimerId++;
+    m_callbacks.emplace(timerId, std::move(callback));
+    m_deadlines.emplace(deadline, timerId);
+    
+    if (!m_thread)
+    {
+        m_thread.reset(new std::thread(&Timer::threadMain, this));
+    }
+    
+    // Wake up the thread only if it should wait less than it does.
+    if (m_deadlines.top().second == timerId)
+    {
+        m_condition.notify_one();
+    }
+    
+    return timerId;
+}
+
+void execq::impl::Timer::cancel(const TimerId timerId)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    
+    // Deadline is left in the heap and skipped when reached.
+    m_callbacks.erase(timerId);
+    
+    if (!m_thread || std::this_thread::get_id() == m_thread->get_id())
+    {
+        return;
+    }
+    
+    m_firedCondition.wait(lock, [&] { return m_firingTimerId != timerId; });
+}
+
+// Private
+
+void execq::impl::Timer::threadMain()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_shouldQuit)
+    {
+        if (m_deadlines.empty())
+        {
+            m_condition.wait(lock);
+            continue;
+        }
+        
+        const Deadline nearest = m_deadlines.top();
+        if (std::chrono::steady_clock::now() < nearest.first)
+        {
+            m_condition.wait_until(lock, nearest.first);
+            continue;
+        }
+        
+        m_deadlines.pop();
+        
+        const auto callbackIt = m_callbacks.find(nearest.second);
+        if (callbackIt == m_callbacks.end())
+        {
+            continue;
+        }
+        
+        const std::function<void()> callback = std::move(callbackIt->second);
+        m_callbacks.erase(callbackIt);
+        
+        m_firingTimerId = nearest.second;
+        lock.unlock();
+        
+        callback();
+        
+        lock.lock();
+        m_firingTimerId = 0;
+        m_firedCondition.notify_all();
+    }
+}
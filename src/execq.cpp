@@ -24,6 +24,9 @@
 
 #include "execq.h"
 #include "ExecutionStream.h"
+#include "EventSource.h"
+#include "ActorSystem.h"
+#include "AsyncSemaphore.h"
 
 namespace
 {
@@ -61,10 +64,59 @@ std::shared_ptr<execq::IExecutionPool> execq::CreateExecutionPool(const uint32_t
     return CreateDefaultExecutionPool(threadCount);
 }
 
+std::shared_ptr<execq::IExecutionPool> execq::DefaultExecutionPool()
+{
+    static const std::shared_ptr<IExecutionPool> s_pool = CreateExecutionPool();
+    return s_pool;
+}
+
 std::unique_ptr<execq::IExecutionStream> execq::CreateExecutionStream(std::shared_ptr<IExecutionPool> executionPool,
                                                                       std::function<void(const std::atomic_bool& isCanceled)> executee)
+{
+    return impl::CreateExecutionStream(executionPool, std::move(executee));
+}
+
+std::unique_ptr<execq::IExecutionStream> execq::impl::CreateExecutionStream(std::shared_ptr<IExecutionPool> executionPool,
+                                                                            MoveOnlyFunction<void(const std::atomic_bool& isCanceled)> executee)
 {
     return std::unique_ptr<impl::ExecutionStream>(new impl::ExecutionStream(executionPool,
                                                                             *impl::IThreadWorkerFactory::defaultFactory(),
                                                                             std::move(executee)));
 }
+
+std::unique_ptr<execq::IEventSource> execq::CreateEventSource(std::shared_ptr<IExecutionPool> executionPool,
+                                                              const EventMerge merge,
+                                                              std::function<void(const std::atomic_bool& isCanceled, const uint64_t value)> handler)
+{
+    return std::unique_ptr<impl::EventSource>(new impl::EventSource(merge,
+                                                                    executionPool,
+                                                                    *impl::IThreadWorkerFactory::defaultFactory(),
+                                                                    std::move(handler)));
+}
+
+std::shared_ptr<execq::IActorSystem> execq::CreateActorSystem(std::shared_ptr<IExecutionPool> executionPool, const size_t messageBudget)
+{
+    if (!messageBudget)
+    {
+        throw std::invalid_argument("Failed to create IActorSystem: message budget could not be zero.");
+    }
+    
+    return std::make_shared<impl::ActorSystem>(executionPool, *impl::IThreadWorkerFactory::defaultFactory(), messageBudget);
+}
+
+std::unique_ptr<execq::IAsyncSemaphore> execq::CreateAsyncSemaphore(std::shared_ptr<IExecutionPool> executionPool, const size_t permitCount)
+{
+    if (!permitCount)
+    {
+        throw std::invalid_argument("Failed to create IAsyncSemaphore: permit count could not be zero.");
+    }
+    
+    return std::unique_ptr<impl::AsyncSemaphore>(new impl::AsyncSemaphore(permitCount,
+                                                                          executionPool,
+                                                                          *impl::IThreadWorkerFactory::defaultFactory()));
+}
+
+std::unique_ptr<execq::IAsyncSemaphore> execq::CreateAsyncMutex(std::shared_ptr<IExecutionPool> executionPool)
+{
+    return CreateAsyncSemaphore(executionPool, 1);
+}
@@ -0,0 +1,158 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+using namespace execq::test;
+
+TEST(ExecutionPool, Actor_MessageBudget)
+{
+    auto executionPool = std::make_shared<MockExecutionPool>();
+    MockThreadWorkerFactory workerFactory {};
+    
+    execq::impl::ITaskProvider* registeredProvider = nullptr;
+    EXPECT_CALL(*executionPool, addProvider(SaveArgAddress(&registeredProvider)))
+    .WillOnce(::testing::Return());
+    
+    std::unique_ptr<MockThreadWorker> additionalWorkerPtr(new MockThreadWorker{});
+    EXPECT_CALL(workerFactory, createWorker(::testing::_))
+    .WillOnce(::testing::Return(::testing::ByMove(std::move(additionalWorkerPtr))));
+    
+    auto actorSystem = std::make_shared<execq::impl::ActorSystem>(executionPool, workerFactory, 2);
+    ASSERT_NE(registeredProvider, nullptr);
+    
+    std::vector<std::string> processed;
+    std::unique_ptr<execq::IActor<std::string>> actor1 = execq::CreateActor<std::string>(actorSystem, [&] (const std::atomic_bool&, std::string&& message) {
+        processed.push_back("1" + message);
+    });
+    std::unique_ptr<execq::IActor<std::string>> actor2 = execq::CreateActor<std::string>(actorSystem, [&] (const std::atomic_bool&, std::string&& message) {
+        processed.push_back("2" + message);
+    });
+    
+    // Nothing sent, nothing to execute
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    
+    // Only the first message into empty mailbox schedules the actor
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .Times(2).WillRepeatedly(::testing::Return(true));
+    actor1->send("a");
+    actor1->send("b");
+    actor1->send("c");
+    actor2->send("a");
+    ::testing::Mock::VerifyAndClearExpectations(executionPool.get());
+    
+    // The first actor runs out of budget and goes after the second one
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .WillOnce(::testing::Return(true));
+    execq::impl::Task task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    ::testing::Mock::VerifyAndClearExpectations(executionPool.get());
+    
+    task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    
+    task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    EXPECT_EQ(processed, std::vector<std::string>({ "1a", "1b", "2a", "1c" }));
+    
+    actor1.reset();
+    actor2.reset();
+    
+    EXPECT_CALL(*executionPool, removeProvider(::testing::_))
+    .WillOnce(::testing::Return());
+    actorSystem.reset();
+}
+
+TEST(ExecutionPool, Actor_ManyActors)
+{
+    auto executionPool = execq::CreateExecutionPool();
+    std::shared_ptr<execq::IActorSystem> actorSystem = execq::CreateActorSystem(executionPool, 4);
+    
+    struct Session
+    {
+        std::vector<int> received;
+        std::atomic_bool isProcessing { false };
+        std::unique_ptr<execq::IActor<int>> actor;
+    };
+    
+    const size_t actorCount = 1000;
+    const int messageCount = 20;
+    std::vector<std::unique_ptr<Session>> sessions;
+    for (size_t i = 0; i < actorCount; i++)
+    {
+        Session* session = new Session;
+        sessions.emplace_back(session);
+        session->actor = execq::CreateActor<int>(actorSystem, [session] (const std::atomic_bool&, int&& message) {
+            // Messages of single actor are never processed simultaneously.
+            EXPECT_FALSE(session->isProcessing.exchange(true));
+            session->received.push_back(message);
+            session->isProcessing = false;
+        });
+    }
+    
+    std::vector<std::thread> senders;
+    for (int sender = 0; sender < 2; sender++)
+    {
+        senders.emplace_back([&, sender] {
+            for (int i = 0; i < messageCount; i++)
+            {
+                for (const auto& session : sessions)
+                {
+                    session->actor->send(sender * messageCount + i);
+                }
+            }
+        });
+    }
+    
+    for (auto& sender : senders)
+    {
+        sender.join();
+    }
+    
+    for (const auto& session : sessions)
+    {
+        // Destroying the actor waits for all its messages.
+        session->actor.reset();
+        ASSERT_EQ(session->received.size(), 2 * messageCount);
+        
+        // Messages of each sender are processed in the order they are sent.
+        std::vector<int> fromFirst;
+        std::copy_if(session->received.begin(), session->received.end(), std::back_inserter(fromFirst), [&] (int message) {
+            return message < messageCount;
+        });
+        ASSERT_EQ(fromFirst.size(), messageCount);
+        EXPECT_TRUE(std::is_sorted(fromFirst.begin(), fromFirst.end()));
+    }
+}
+
+TEST(ExecutionPool, Actor_NullPool)
+{
+    EXPECT_THROW(execq::CreateActorSystem(nullptr), std::invalid_argument);
+}
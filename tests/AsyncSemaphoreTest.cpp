@@ -0,0 +1,131 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "AsyncSemaphore.h"
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+using namespace execq::test;
+
+TEST(ExecutionPool, AsyncSemaphore_Mutex)
+{
+    auto executionPool = std::make_shared<MockExecutionPool>();
+    MockThreadWorkerFactory workerFactory {};
+    
+    execq::impl::ITaskProvider* registeredProvider = nullptr;
+    EXPECT_CALL(*executionPool, addProvider(SaveArgAddress(&registeredProvider)))
+    .WillOnce(::testing::Return());
+    
+    std::unique_ptr<MockThreadWorker> additionalWorkerPtr(new MockThreadWorker{});
+    EXPECT_CALL(workerFactory, createWorker(::testing::_))
+    .WillOnce(::testing::Return(::testing::ByMove(std::move(additionalWorkerPtr))));
+    
+    std::unique_ptr<execq::impl::AsyncSemaphore> mutex(new execq::impl::AsyncSemaphore(1, executionPool, workerFactory));
+    ASSERT_NE(registeredProvider, nullptr);
+    
+    std::vector<std::string> order;
+    execq::AsyncPermit heldPermit;
+    
+    // Free mutex: continuation is scheduled right away
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .WillOnce(::testing::Return(true));
+    mutex->acquire([&] (const std::atomic_bool&, execq::AsyncPermit permit) {
+        order.push_back("first");
+        
+        // Keep holding the mutex after the continuation returns
+        heldPermit = std::move(permit);
+    });
+    ::testing::Mock::VerifyAndClearExpectations(executionPool.get());
+    
+    // Mutex is taken: continuation just waits
+    mutex->acquire([&] (const std::atomic_bool&, execq::AsyncPermit) {
+        order.push_back("second");
+    });
+    EXPECT_FALSE(mutex->tryAcquire());
+    
+    execq::impl::Task task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    EXPECT_TRUE(heldPermit);
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    
+    // Release schedules the next waiter
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .WillOnce(::testing::Return(true));
+    heldPermit.release();
+    ::testing::Mock::VerifyAndClearExpectations(executionPool.get());
+    
+    task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    
+    EXPECT_EQ(order, std::vector<std::string>({ "first", "second" }));
+    
+    // Released by the end of the continuation
+    execq::AsyncPermit permit = mutex->tryAcquire();
+    EXPECT_TRUE(permit);
+    permit.release();
+    
+    EXPECT_CALL(*executionPool, removeProvider(::testing::_))
+    .WillOnce(::testing::Return());
+}
+
+TEST(ExecutionPool, AsyncSemaphore_Limit)
+{
+    auto executionPool = execq::CreateExecutionPool();
+    std::unique_ptr<execq::IAsyncSemaphore> semaphore = execq::CreateAsyncSemaphore(executionPool, 2);
+    
+    const int count = 100;
+    std::atomic_int holders { 0 };
+    std::atomic_int maxHolders { 0 };
+    std::atomic_int done { 0 };
+    std::promise<void> allDone;
+    
+    for (int i = 0; i < count; i++)
+    {
+        semaphore->acquire([&] (const std::atomic_bool& isCanceled, execq::AsyncPermit) {
+            EXPECT_FALSE(isCanceled);
+            
+            const int current = ++holders;
+            int maxCurrent = maxHolders;
+            while (current > maxCurrent && !maxHolders.compare_exchange_weak(maxCurrent, current))
+            {}
+            
+            holders--;
+            if (++done == count)
+            {
+                allDone.set_value();
+            }
+        });
+    }
+    
+    EXPECT_EQ(allDone.get_future().wait_for(kTimeout), std::future_status::ready);
+    EXPECT_LE(maxHolders, 2);
+}
+
+TEST(ExecutionPool, AsyncSemaphore_NullPool)
+{
+    EXPECT_THROW(execq::CreateAsyncSemaphore(nullptr, 2), std::invalid_argument);
+    EXPECT_THROW(execq::CreateAsyncMutex(nullptr), std::invalid_argument);
+}
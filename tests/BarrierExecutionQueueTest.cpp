@@ -0,0 +1,156 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+using namespace execq::test;
+
+TEST(ExecutionPool, BarrierExecutionQueue_Order)
+{
+    auto executionPool = std::make_shared<MockExecutionPool>();
+    MockThreadWorkerFactory workerFactory {};
+    
+    execq::impl::ITaskProvider* registeredProvider = nullptr;
+    EXPECT_CALL(*executionPool, addProvider(SaveArgAddress(&registeredProvider)))
+    .WillOnce(::testing::Return());
+    
+    std::unique_ptr<MockThreadWorker> additionalWorkerPtr(new MockThreadWorker{});
+    EXPECT_CALL(workerFactory, createWorker(::testing::_))
+    .WillOnce(::testing::Return(::testing::ByMove(std::move(additionalWorkerPtr))));
+    
+    std::vector<std::string> processed;
+    std::unique_ptr<execq::impl::BarrierExecutionQueue<std::string, void>> queue(new execq::impl::BarrierExecutionQueue<std::string, void>(executionPool, workerFactory, [&] (const std::atomic_bool&, std::string&& object) {
+        processed.push_back(object);
+    }));
+    ASSERT_NE(registeredProvider, nullptr);
+    
+    // Shared objects ahead of the exclusive one notify the pool, the rest wait.
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .Times(2).WillRepeatedly(::testing::Return(true));
+    queue->push("s1");
+    queue->push("s2");
+    queue->pushExclusive("x");
+    queue->push("s3");
+    queue->push("s4");
+    ::testing::Mock::VerifyAndClearExpectations(executionPool.get());
+    
+    execq::impl::Task s1 = registeredProvider->nextTask();
+    execq::impl::Task s2 = registeredProvider->nextTask();
+    ASSERT_TRUE(s1.valid());
+    ASSERT_TRUE(s2.valid());
+    
+    // Exclusive object waits for shared objects being processed.
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    s1();
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .WillOnce(::testing::Return(true));
+    s2();
+    ::testing::Mock::VerifyAndClearExpectations(executionPool.get());
+    
+    execq::impl::Task x = registeredProvider->nextTask();
+    ASSERT_TRUE(x.valid());
+    
+    // Shared objects wait for the exclusive one.
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    
+    // Then all of them are released at once.
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .Times(2).WillRepeatedly(::testing::Return(true));
+    x();
+    ::testing::Mock::VerifyAndClearExpectations(executionPool.get());
+    
+    execq::impl::Task s3 = registeredProvider->nextTask();
+    execq::impl::Task s4 = registeredProvider->nextTask();
+    ASSERT_TRUE(s3.valid());
+    ASSERT_TRUE(s4.valid());
+    s4();
+    s3();
+    
+    EXPECT_EQ(processed, std::vector<std::string>({ "s1", "s2", "x", "s4", "s3" }));
+    
+    EXPECT_CALL(*executionPool, removeProvider(::testing::_))
+    .WillOnce(::testing::Return());
+}
+
+TEST(ExecutionPool, BarrierExecutionQueue_Exclusive)
+{
+    auto executionPool = execq::CreateExecutionPool();
+    
+    std::atomic_int sharedRunning { 0 };
+    std::atomic_bool exclusiveRunning { false };
+    std::atomic_int maxSharedRunning { 0 };
+    int value = 0;
+    
+    auto queue = execq::CreateBarrierExecutionQueue<int, int>(executionPool, [&] (const std::atomic_bool&, int&& delta) {
+        if (!delta)
+        {
+            const int running = ++sharedRunning;
+            EXPECT_FALSE(exclusiveRunning);
+            
+            int maxRunning = maxSharedRunning;
+            while (running > maxRunning && !maxSharedRunning.compare_exchange_weak(maxRunning, running))
+            {}
+            
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            const int result = value;
+            sharedRunning--;
+            return result;
+        }
+        
+        EXPECT_FALSE(exclusiveRunning.exchange(true));
+        EXPECT_EQ(sharedRunning, 0);
+        value += delta;
+        exclusiveRunning = false;
+        return value;
+    });
+    
+    std::vector<std::future<int>> reads;
+    for (int i = 1; i <= 10; i++)
+    {
+        for (int j = 0; j < 8; j++)
+        {
+            reads.push_back(queue->push(0));
+        }
+        queue->pushExclusive(1);
+    }
+    
+    // Each group of reads sees all writes pushed before it and none pushed after.
+    for (size_t i = 0; i < reads.size(); i++)
+    {
+        ASSERT_EQ(reads[i].wait_for(kTimeout), std::future_status::ready);
+        EXPECT_EQ(reads[i].get(), i / 8);
+    }
+    
+    EXPECT_GT(maxSharedRunning, 1);
+}
+
+TEST(ExecutionPool, BarrierExecutionQueue_NullPool)
+{
+    EXPECT_THROW((execq::CreateBarrierExecutionQueue<int, int>(nullptr, [] (const std::atomic_bool&, int&& object) {
+        return object;
+    })), std::invalid_argument);
+}
@@ -0,0 +1,187 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+using namespace execq::test;
+
+namespace
+{
+    struct BatchRecord
+    {
+        bool canceled;
+        std::vector<int> objects;
+        uint64_t firstIndex;
+        bool aligned;
+    };
+    
+    std::unique_ptr<execq::impl::BatchExecutionQueue<int>> MakeBatchQueue(std::shared_ptr<MockExecutionPool> executionPool,
+                                                                          execq::impl::ITaskProvider*& registeredProvider,
+                                                                          std::vector<BatchRecord>& batches)
+    {
+        MockThreadWorkerFactory workerFactory {};
+        EXPECT_CALL(*executionPool, addProvider(SaveArgAddress(&registeredProvider)))
+        .WillOnce(::testing::Return());
+        
+        std::unique_ptr<MockThreadWorker> additionalWorkerPtr(new MockThreadWorker{});
+        EXPECT_CALL(workerFactory, createWorker(::testing::_))
+        .WillOnce(::testing::Return(::testing::ByMove(std::move(additionalWorkerPtr))));
+        
+        const size_t batchSize = 2;
+        return std::unique_ptr<execq::impl::BatchExecutionQueue<int>>(new execq::impl::BatchExecutionQueue<int>(executionPool, workerFactory, batchSize, [&batches] (const std::atomic_bool& isCanceled, execq::ObjectBatch<int> batch) {
+            const bool aligned = reinterpret_cast<uintptr_t>(batch.objects) % execq::kBatchAlignment == 0;
+            batches.push_back({ isCanceled, std::vector<int>(batch.objects, batch.objects + batch.count), batch.firstIndex, aligned });
+        }));
+    }
+}
+
+TEST(ExecutionPool, BatchExecutionQueue_Batches)
+{
+    auto executionPool = std::make_shared<MockExecutionPool>();
+    execq::impl::ITaskProvider* registeredProvider = nullptr;
+    std::vector<BatchRecord> batches;
+    auto queue = MakeBatchQueue(executionPool, registeredProvider, batches);
+    ASSERT_NE(registeredProvider, nullptr);
+    
+    
+    // Each full batch is notified separately
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .Times(2).WillRepeatedly(::testing::Return(true));
+    
+    const int objects[] = { 1, 2, 3, 4, 5 };
+    EXPECT_EQ(queue->push(objects, 5), 0);
+    ::testing::Mock::VerifyAndClearExpectations(executionPool.get());
+    
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .WillOnce(::testing::Return(true));
+    EXPECT_EQ(queue->push(6), 5);
+    ::testing::Mock::VerifyAndClearExpectations(executionPool.get());
+    
+    // There are pending objects, so no reason to notify about partial batch
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .Times(0);
+    EXPECT_EQ(queue->push(7), 6);
+    
+    
+    // Batches are contiguous and aligned
+    for (int i = 0; i < 4; i++)
+    {
+        execq::impl::Task task = registeredProvider->nextTask();
+        ASSERT_TRUE(task.valid());
+        task();
+    }
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    
+    ASSERT_EQ(batches.size(), 4);
+    EXPECT_EQ(batches[0].objects, std::vector<int>({ 1, 2 }));
+    EXPECT_EQ(batches[0].firstIndex, 0);
+    EXPECT_EQ(batches[1].objects, std::vector<int>({ 3, 4 }));
+    EXPECT_EQ(batches[1].firstIndex, 2);
+    EXPECT_EQ(batches[2].objects, std::vector<int>({ 5, 6 }));
+    EXPECT_EQ(batches[2].firstIndex, 4);
+    
+    // Partial batch is taken without waiting for more objects
+    EXPECT_EQ(batches[3].objects, std::vector<int>({ 7 }));
+    EXPECT_EQ(batches[3].firstIndex, 6);
+    
+    for (const BatchRecord& batch : batches)
+    {
+        EXPECT_TRUE(batch.aligned);
+        EXPECT_FALSE(batch.canceled);
+    }
+    
+    
+    EXPECT_CALL(*executionPool, removeProvider(::testing::_))
+    .WillOnce(::testing::Return());
+}
+
+TEST(ExecutionPool, BatchExecutionQueue_Cancelability)
+{
+    auto executionPool = std::make_shared<MockExecutionPool>();
+    execq::impl::ITaskProvider* registeredProvider = nullptr;
+    std::vector<BatchRecord> batches;
+    auto queue = MakeBatchQueue(executionPool, registeredProvider, batches);
+    ASSERT_NE(registeredProvider, nullptr);
+    
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .WillRepeatedly(::testing::Return(true));
+    
+    
+    // Objects pushed after 'cancel' call never get into the same batch with canceled objects
+    queue->push(1);
+    queue->cancel();
+    queue->push(2);
+    
+    for (int i = 0; i < 2; i++)
+    {
+        execq::impl::Task task = registeredProvider->nextTask();
+        ASSERT_TRUE(task.valid());
+        task();
+    }
+    
+    ASSERT_EQ(batches.size(), 2);
+    EXPECT_EQ(batches[0].objects, std::vector<int>({ 1 }));
+    EXPECT_TRUE(batches[0].canceled);
+    EXPECT_EQ(batches[1].objects, std::vector<int>({ 2 }));
+    EXPECT_FALSE(batches[1].canceled);
+    
+    
+    EXPECT_CALL(*executionPool, removeProvider(::testing::_))
+    .WillOnce(::testing::Return());
+}
+
+TEST(ExecutionPool, BatchExecutionQueue_MultipleObjects)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    const size_t count = 10000;
+    std::vector<std::atomic_int> results(count);
+    
+    auto queue = execq::CreateBatchExecutionQueue<uint32_t>(pool, 64, [&results] (const std::atomic_bool&, execq::ObjectBatch<uint32_t> batch) {
+        for (size_t i = 0; i < batch.count; i++)
+        {
+            results[batch.firstIndex + i] += batch.objects[i];
+        }
+    });
+    
+    for (uint32_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(queue->push(i), i);
+    }
+    
+    // when destroyed, queue waits until all objects are processed
+    queue.reset();
+    
+    for (uint32_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(results[i], i);
+    }
+}
+
+TEST(ExecutionPool, BatchExecutionQueue_NullPool)
+{
+    EXPECT_THROW(execq::CreateBatchExecutionQueue<uint32_t>(nullptr, 64, [] (const std::atomic_bool&, execq::ObjectBatch<uint32_t>) {}),
+                 std::invalid_argument);
+}
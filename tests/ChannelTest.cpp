@@ -0,0 +1,134 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+#include <thread>
+
+using namespace execq::test;
+
+TEST(ExecutionPool, Channel_SendReceive)
+{
+    execq::Channel<int> channel(2);
+    
+    EXPECT_TRUE(channel.trySend(1));
+    EXPECT_TRUE(channel.send(2));
+    EXPECT_FALSE(channel.trySend(3));
+    
+    // Blocked sender continues as soon as the value is received.
+    std::thread sender([&] {
+        EXPECT_TRUE(channel.send(3));
+    });
+    
+    int value = 0;
+    EXPECT_TRUE(channel.receive(value));
+    EXPECT_EQ(value, 1);
+    sender.join();
+    
+    channel.close();
+    EXPECT_FALSE(channel.send(4));
+    
+    // Values sent before closing are still received.
+    EXPECT_TRUE(channel.tryReceive(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_TRUE(channel.receive(value));
+    EXPECT_EQ(value, 3);
+    EXPECT_FALSE(channel.receive(value));
+}
+
+TEST(ExecutionPool, Channel_Select)
+{
+    execq::Channel<int> numbers(4);
+    execq::Channel<std::string> strings(4);
+    
+    std::vector<int> receivedNumbers;
+    std::vector<std::string> receivedStrings;
+    
+    execq::ChannelSelector selector;
+    selector
+    .onReceive<int>(numbers, [&] (int&& value) { receivedNumbers.push_back(value); })
+    .onReceive<std::string>(strings, [&] (std::string&& value) { receivedStrings.push_back(value); });
+    
+    EXPECT_FALSE(selector.trySelect());
+    
+    std::thread sender([&] {
+        numbers.send(1);
+        strings.send("qwe");
+        numbers.send(2);
+        numbers.close();
+        strings.close();
+    });
+    
+    while (selector.select())
+    {}
+    sender.join();
+    
+    EXPECT_EQ(receivedNumbers, std::vector<int>({ 1, 2 }));
+    EXPECT_EQ(receivedStrings, std::vector<std::string>({ "qwe" }));
+}
+
+TEST(ExecutionPool, Channel_PoolReceiver)
+{
+    auto executionPool = execq::CreateExecutionPool();
+    auto channel = std::make_shared<execq::Channel<int>>(4);
+    
+    const int count = 100;
+    std::atomic_int sum { 0 };
+    std::atomic_int received { 0 };
+    std::promise<void> allReceived;
+    
+    std::unique_ptr<execq::IChannelReceiver> receiver = execq::CreateChannelReceiver<int>(executionPool, channel, [&] (const std::atomic_bool& isCanceled, int&& value) {
+        EXPECT_FALSE(isCanceled);
+        sum += value;
+        if (++received == count)
+        {
+            allReceived.set_value();
+        }
+    });
+    
+    // Sending blocks while the channel is full, so the receiver has to keep up.
+    for (int i = 1; i <= count; i++)
+    {
+        EXPECT_TRUE(channel->send(i));
+    }
+    
+    EXPECT_EQ(allReceived.get_future().wait_for(kTimeout), std::future_status::ready);
+    EXPECT_EQ(sum, count * (count + 1) / 2);
+    
+    receiver.reset();
+    
+    // Destroyed receiver doesn't consume values anymore.
+    EXPECT_TRUE(channel->send(0));
+    int value = -1;
+    EXPECT_TRUE(channel->tryReceive(value));
+    EXPECT_EQ(value, 0);
+}
+
+TEST(ExecutionPool, Channel_PoolReceiverNullPool)
+{
+    auto channel = std::make_shared<execq::Channel<int>>(1);
+    EXPECT_THROW(execq::CreateChannelReceiver<int>(nullptr, channel, [] (const std::atomic_bool&, int&&) {}),
+                 std::invalid_argument);
+}
@@ -0,0 +1,174 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ClosureQueue.h"
+#include "ExecqTestUtil.h"
+
+#include <array>
+#include <numeric>
+
+using namespace execq::test;
+
+namespace
+{
+    struct MoveOnlyFunction
+    {
+        std::unique_ptr<int> value;
+        
+        int operator()()
+        {
+            return *value;
+        }
+    };
+    
+    struct LargeFunction
+    {
+        std::array<uint64_t, 32> values;
+        std::shared_ptr<std::atomic_int> called;
+        
+        void operator()()
+        {
+            *called += std::accumulate(values.begin(), values.end(), 0);
+        }
+    };
+}
+
+TEST(ExecutionPool, Closure_Storage)
+{
+    // Small move-only callable is stored inline
+    execq::impl::Closure closure;
+    EXPECT_FALSE(closure);
+    
+    int result = 0;
+    closure = execq::impl::Closure([&result] { result = 1; });
+    EXPECT_TRUE(closure);
+    closure();
+    EXPECT_EQ(result, 1);
+    
+    // Large callable is moved to the heap and survives moving of the closure
+    std::shared_ptr<std::atomic_int> called = std::make_shared<std::atomic_int>(0);
+    LargeFunction largeFunction;
+    largeFunction.values.fill(1);
+    largeFunction.called = called;
+    
+    execq::impl::Closure largeClosure(std::move(largeFunction));
+    execq::impl::Closure movedClosure(std::move(largeClosure));
+    EXPECT_FALSE(largeClosure);
+    movedClosure();
+    EXPECT_EQ(*called, 32);
+    
+    // Callable is destroyed with the closure
+    movedClosure = execq::impl::Closure();
+    EXPECT_EQ(called.use_count(), 1);
+}
+
+TEST(ExecutionPool, ClosureQueue_Async)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    std::future<int> result = execq::Async(pool, [] { return 42; });
+    ASSERT_EQ(result.wait_for(kTimeout), std::future_status::ready);
+    EXPECT_EQ(result.get(), 42);
+    
+    // Move-only functions are supported
+    MoveOnlyFunction moveOnlyFunction { std::unique_ptr<int>(new int(7)) };
+    std::future<int> moveOnlyResult = execq::Async(pool, std::move(moveOnlyFunction));
+    EXPECT_EQ(moveOnlyResult.get(), 7);
+    
+    // Exceptions are delivered through the future
+    std::future<void> failed = execq::Async(pool, [] { throw std::runtime_error("failed"); });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+}
+
+TEST(ExecutionPool, ClosureQueue_TaskClaimsClosure)
+{
+    auto executionPool = std::make_shared<MockExecutionPool>();
+    MockThreadWorkerFactory workerFactory {};
+    
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .WillRepeatedly(::testing::Return(true));
+    
+    execq::impl::ITaskProvider* registeredProvider = nullptr;
+    EXPECT_CALL(*executionPool, addProvider(SaveArgAddress(&registeredProvider)))
+    .WillOnce(::testing::Return());
+    
+    std::unique_ptr<MockThreadWorker> additionalWorkerPtr(new MockThreadWorker{});
+    EXPECT_CALL(workerFactory, createWorker(::testing::_))
+    .WillOnce(::testing::Return(::testing::ByMove(std::move(additionalWorkerPtr))));
+    
+    std::unique_ptr<execq::impl::ClosureQueue> queue(new execq::impl::ClosureQueue(*executionPool, workerFactory));
+    ASSERT_NE(registeredProvider, nullptr);
+    
+    int executedCount = 0;
+    queue->post(execq::impl::Closure([&executedCount] { executedCount++; }));
+    
+    // The closure is claimed by the first task, so workers polling before it runs get nothing
+    execq::impl::Task task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    
+    task();
+    EXPECT_EQ(executedCount, 1);
+    
+    EXPECT_CALL(*executionPool, removeProvider(::testing::_))
+    .WillOnce(::testing::Return());
+    queue.reset();
+}
+
+TEST(ExecutionPool, ClosureQueue_Post)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    std::atomic_int sum { 0 };
+    std::promise<void> done;
+    const int count = 100;
+    for (int i = 1; i <= count; i++)
+    {
+        execq::Post(pool, [&sum, &done, i] {
+            if ((sum += i) == count * (count + 1) / 2)
+            {
+                done.set_value();
+            }
+        });
+    }
+    
+    // Exception thrown by posted function doesn't break the queue
+    execq::Post(pool, [] { throw std::runtime_error("ignored"); });
+    
+    EXPECT_EQ(done.get_future().wait_for(kTimeout), std::future_status::ready);
+}
+
+TEST(ExecutionPool, ClosureQueue_DefaultPool)
+{
+    EXPECT_EQ(execq::DefaultExecutionPool(), execq::DefaultExecutionPool());
+    
+    std::future<int> result = execq::Async([] { return 1; });
+    ASSERT_EQ(result.wait_for(kTimeout), std::future_status::ready);
+    EXPECT_EQ(result.get(), 1);
+    
+    std::promise<void> posted;
+    execq::Post([&posted] { posted.set_value(); });
+    EXPECT_EQ(posted.get_future().wait_for(kTimeout), std::future_status::ready);
+}
@@ -0,0 +1,156 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+using namespace execq::test;
+
+namespace
+{
+    using Update = std::pair<int, std::string>;
+    
+    std::unique_ptr<execq::impl::CoalescingExecutionQueue<int, Update, std::string>> MakeCoalescingQueue(std::shared_ptr<MockExecutionPool> executionPool,
+                                                                                                         execq::impl::ITaskProvider*& registeredProvider,
+                                                                                                         std::function<void(Update& pending, Update&& object)> merge)
+    {
+        MockThreadWorkerFactory workerFactory {};
+        EXPECT_CALL(*executionPool, addProvider(SaveArgAddress(&registeredProvider)))
+        .WillOnce(::testing::Return());
+        
+        std::unique_ptr<MockThreadWorker> additionalWorkerPtr(new MockThreadWorker{});
+        EXPECT_CALL(workerFactory, createWorker(::testing::_))
+        .WillOnce(::testing::Return(::testing::ByMove(std::move(additionalWorkerPtr))));
+        
+        return std::unique_ptr<execq::impl::CoalescingExecutionQueue<int, Update, std::string>>(new execq::impl::CoalescingExecutionQueue<int, Update, std::string>(executionPool, workerFactory, [] (const Update& object) {
+            return object.first;
+        }, [] (const std::atomic_bool&, Update&& object) {
+            return object.second;
+        }, std::move(merge)));
+    }
+}
+
+TEST(ExecutionPool, CoalescingExecutionQueue_Replace)
+{
+    auto executionPool = std::make_shared<MockExecutionPool>();
+    execq::impl::ITaskProvider* registeredProvider = nullptr;
+    auto queue = MakeCoalescingQueue(executionPool, registeredProvider, nullptr);
+    ASSERT_NE(registeredProvider, nullptr);
+    
+    // Only pushes of new keys notify workers
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .Times(2).WillRepeatedly(::testing::Return(true));
+    
+    std::shared_future<std::string> first = queue->push(Update(1, "a"));
+    std::shared_future<std::string> second = queue->push(Update(2, "b"));
+    std::shared_future<std::string> third = queue->push(Update(1, "c"));
+    ::testing::Mock::VerifyAndClearExpectations(executionPool.get());
+    
+    // Coalesced object keeps its position
+    execq::impl::Task task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    ASSERT_EQ(first.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    EXPECT_EQ(first.get(), "c");
+    EXPECT_EQ(third.get(), "c");
+    EXPECT_EQ(second.wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+    
+    // Object being processed is not coalesced anymore
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .WillOnce(::testing::Return(true));
+    std::shared_future<std::string> fourth = queue->push(Update(1, "d"));
+    
+    task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    EXPECT_EQ(second.get(), "b");
+    
+    task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    EXPECT_EQ(fourth.get(), "d");
+    
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    
+    EXPECT_CALL(*executionPool, removeProvider(::testing::_))
+    .WillOnce(::testing::Return());
+}
+
+TEST(ExecutionPool, CoalescingExecutionQueue_Merge)
+{
+    auto executionPool = std::make_shared<MockExecutionPool>();
+    execq::impl::ITaskProvider* registeredProvider = nullptr;
+    auto queue = MakeCoalescingQueue(executionPool, registeredProvider, [] (Update& pending, Update&& object) {
+        pending.second += object.second;
+    });
+    ASSERT_NE(registeredProvider, nullptr);
+    
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .WillOnce(::testing::Return(true));
+    
+    std::shared_future<std::string> first = queue->push(Update(1, "a"));
+    queue->push(Update(1, "b"));
+    queue->push(Update(1, "c"));
+    
+    execq::impl::Task task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    EXPECT_EQ(first.get(), "abc");
+    
+    EXPECT_CALL(*executionPool, removeProvider(::testing::_))
+    .WillOnce(::testing::Return());
+}
+
+TEST(ExecutionPool, CoalescingExecutionQueue_RealPool)
+{
+    auto pool = execq::CreateExecutionPool(2);
+    
+    std::atomic_int processedCount { 0 };
+    auto queue = execq::CreateCoalescingExecutionQueue<int, int, void>(pool, [] (const int& object) {
+        return object % 10;
+    }, [&] (const std::atomic_bool&, int&&) {
+        processedCount++;
+    });
+    
+    std::vector<std::shared_future<void>> futures;
+    for (int i = 0; i < 1000; i++)
+    {
+        futures.push_back(queue->push(i));
+    }
+    
+    for (const auto& future : futures)
+    {
+        EXPECT_EQ(future.wait_for(kTimeout), std::future_status::ready);
+    }
+    
+    EXPECT_LE(processedCount, 1000);
+    EXPECT_GE(processedCount, 10);
+}
+
+TEST(ExecutionPool, CoalescingExecutionQueue_NullPool)
+{
+    EXPECT_THROW((execq::CreateCoalescingExecutionQueue<int, int, void>(nullptr, [] (const int& object) {
+        return object;
+    }, [] (const std::atomic_bool&, int&&) {})), std::invalid_argument);
+}
@@ -0,0 +1,115 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+#include <gtest/gtest.h>
+
+TEST(ExecutionPool, CompletionQueue_Drain)
+{
+    execq::CompletionQueue<std::string> completionQueue;
+    std::vector<execq::Completion<std::string>> completions;
+    
+    EXPECT_EQ(completionQueue.tryDrain(completions), 0);
+    EXPECT_EQ(completionQueue.drainFor(completions, std::chrono::milliseconds(1)), 0);
+    
+    completionQueue.post(1, "first");
+    completionQueue.post(2, "second");
+    
+    EXPECT_EQ(completionQueue.drain(completions), 2);
+    ASSERT_EQ(completions.size(), 2);
+    EXPECT_EQ(completions[0].tag, 1);
+    EXPECT_EQ(completions[0].result, "first");
+    EXPECT_EQ(completions[1].tag, 2);
+    EXPECT_EQ(completions[1].result, "second");
+    
+    // Completions are appended to non-empty vector
+    completionQueue.post(3, "third");
+    EXPECT_EQ(completionQueue.tryDrain(completions), 1);
+    ASSERT_EQ(completions.size(), 3);
+    EXPECT_EQ(completions[2].tag, 3);
+    EXPECT_EQ(completionQueue.tryDrain(completions), 0);
+}
+
+TEST(ExecutionPool, CompletionQueue_Queue)
+{
+    std::shared_ptr<execq::IExecutionPool> pool = execq::CreateExecutionPool(4);
+    auto completionQueue = std::make_shared<execq::CompletionQueue<size_t>>();
+    
+    auto queue = execq::CreateConcurrentExecutionQueue<std::string, size_t>(pool, [] (const std::atomic_bool&, std::string&& object) {
+        return object.size();
+    });
+    
+    const size_t count = 100;
+    for (size_t i = 0; i < count; i++)
+    {
+        queue->push(std::string(i, 'a'), completionQueue, i);
+    }
+    
+    std::vector<execq::Completion<size_t>> completions;
+    std::vector<execq::Completion<size_t>> batch;
+    while (completions.size() < count)
+    {
+        batch.clear();
+        ASSERT_NE(completionQueue->drainFor(batch, std::chrono::seconds(5)), 0);
+        completions.insert(completions.end(), batch.begin(), batch.end());
+    }
+    
+    std::vector<bool> received(count, false);
+    for (const auto& completion : completions)
+    {
+        ASSERT_LT(completion.tag, count);
+        EXPECT_FALSE(received[completion.tag]);
+        EXPECT_EQ(completion.result, completion.tag);
+        received[completion.tag] = true;
+    }
+    
+    EXPECT_THROW(queue->push("", nullptr, 0), std::invalid_argument);
+}
+
+TEST(ExecutionPool, CompletionQueue_VoidResult)
+{
+    std::shared_ptr<execq::IExecutionPool> pool = execq::CreateExecutionPool(2);
+    auto completionQueue = std::make_shared<execq::CompletionQueue<void>>();
+    
+    std::atomic_int processed { 0 };
+    auto queue = execq::CreateSerialExecutionQueue<int, void>(pool, [&] (const std::atomic_bool&, int&&) {
+        processed++;
+    });
+    
+    queue->push(1, completionQueue, 10);
+    queue->push(2, completionQueue, 20);
+    
+    std::vector<execq::Completion<void>> completions;
+    while (completions.size() < 2)
+    {
+        ASSERT_NE(completionQueue->drainFor(completions, std::chrono::seconds(5)), 0);
+    }
+    
+    // Serial queue completes objects in order
+    EXPECT_EQ(completions[0].tag, 10);
+    EXPECT_EQ(completions[1].tag, 20);
+    EXPECT_EQ(processed, 2);
+}
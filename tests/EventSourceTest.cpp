@@ -0,0 +1,130 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "EventSource.h"
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+using namespace execq::test;
+
+TEST(ExecutionPool, EventSource_Merge)
+{
+    auto executionPool = std::make_shared<MockExecutionPool>();
+    MockThreadWorkerFactory workerFactory {};
+    
+    execq::impl::ITaskProvider* registeredProvider = nullptr;
+    EXPECT_CALL(*executionPool, addProvider(SaveArgAddress(&registeredProvider)))
+    .WillOnce(::testing::Return());
+    
+    std::unique_ptr<MockThreadWorker> additionalWorkerPtr(new MockThreadWorker{});
+    EXPECT_CALL(workerFactory, createWorker(::testing::_))
+    .WillOnce(::testing::Return(::testing::ByMove(std::move(additionalWorkerPtr))));
+    
+    std::vector<uint64_t> values;
+    execq::IEventSource* sourcePtr = nullptr;
+    std::unique_ptr<execq::impl::EventSource> source(new execq::impl::EventSource(execq::EventMerge::Or, executionPool, workerFactory, [&] (const std::atomic_bool&, const uint64_t value) {
+        values.push_back(value);
+        
+        // Signal while the handler is running
+        if (values.size() == 1)
+        {
+            sourcePtr->signal(0x10);
+        }
+    }));
+    sourcePtr = source.get();
+    ASSERT_NE(registeredProvider, nullptr);
+    
+    // Nothing signaled, nothing to execute
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    
+    // Only the first signal schedules the handler
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .WillOnce(::testing::Return(true));
+    source->signal(0x1);
+    source->signal(0x2);
+    source->signal(0x2);
+    source->signal(0);
+    ::testing::Mock::VerifyAndClearExpectations(executionPool.get());
+    
+    execq::impl::Task task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    
+    // Handler invocations never overlap
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    
+    // Signal during the handler schedules next invocation: once from 'signal' and once when the handler is done
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .Times(2).WillRepeatedly(::testing::Return(true));
+    task();
+    ::testing::Mock::VerifyAndClearExpectations(executionPool.get());
+    
+    task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    
+    EXPECT_EQ(values, std::vector<uint64_t>({ 0x3, 0x10 }));
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    
+    EXPECT_CALL(*executionPool, removeProvider(::testing::_))
+    .WillOnce(::testing::Return());
+}
+
+TEST(ExecutionPool, EventSource_Add)
+{
+    auto pool = execq::CreateExecutionPool(4);
+    
+    std::atomic<uint64_t> total { 0 };
+    std::atomic_size_t invocations { 0 };
+    auto source = execq::CreateEventSource(pool, execq::EventMerge::Add, [&] (const std::atomic_bool&, const uint64_t value) {
+        total += value;
+        invocations++;
+    });
+    
+    std::vector<std::thread> producers;
+    for (int i = 0; i < 4; i++)
+    {
+        producers.emplace_back([&source] {
+            for (int j = 0; j < 10000; j++)
+            {
+                source->signal(1);
+            }
+        });
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    
+    // All accumulated values are delivered before the source is destroyed
+    source.reset();
+    
+    EXPECT_EQ(total, 40000);
+    EXPECT_LE(invocations, 40000);
+}
+
+TEST(ExecutionPool, EventSource_NullPool)
+{
+    EXPECT_THROW(execq::CreateEventSource(nullptr, execq::EventMerge::Add, [] (const std::atomic_bool&, const uint64_t) {}),
+                 std::invalid_argument);
+}
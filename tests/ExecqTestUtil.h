@@ -40,6 +40,10 @@ namespace execq
             
             MOCK_METHOD0(notifyOneWorker, bool());
             MOCK_METHOD0(notifyAllWorkers, void());
+            MOCK_METHOD1(notifyOneWorker, bool(const execq::impl::TaskAffinity& affinity));
+            
+            MOCK_METHOD0(timer, execq::impl::Timer&());
+            MOCK_METHOD0(closureQueue, execq::impl::ClosureQueue&());
         };
         
         class MockThreadWorkerFactory: public execq::impl::IThreadWorkerFactory
@@ -52,6 +56,8 @@ namespace execq
         {
         public:
             MOCK_METHOD0(notifyWorker, bool());
+            MOCK_METHOD0(enableSignals, void());
+            MOCK_METHOD0(signalWorker, void());
         };
         
         static const std::chrono::milliseconds kLongTermJob { 100 };
@@ -0,0 +1,248 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ExecutionPool.h"
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+using namespace ::testing;
+
+namespace
+{
+    class MockTaskProvider: public execq::impl::ITaskProvider
+    {
+    public:
+        MOCK_METHOD0(nextTask, execq::impl::Task());
+        
+        virtual const execq::impl::TaskAffinity* affinity() const final
+        {
+            return &taskAffinity;
+        }
+        
+        execq::impl::TaskAffinity taskAffinity;
+    };
+    
+    execq::impl::Task MakeValidTask()
+    {
+        return execq::impl::Task([] {});
+    }
+    
+    std::unique_ptr<execq::impl::ExecutionPool> MakePool(const uint32_t threadCount,
+                                                          std::vector<execq::impl::ITaskProvider*>& workerProviders)
+    {
+        execq::test::MockThreadWorkerFactory workerFactory;
+        EXPECT_CALL(workerFactory, createWorker(_))
+        .Times(threadCount)
+        .WillRepeatedly(Invoke([&workerProviders] (execq::impl::ITaskProvider& provider) {
+            workerProviders.push_back(&provider);
+            return std::unique_ptr<execq::impl::IThreadWorker>(new NiceMock<execq::test::MockThreadWorker>());
+        }));
+        
+        return std::unique_ptr<execq::impl::ExecutionPool>(new execq::impl::ExecutionPool(threadCount, workerFactory));
+    }
+}
+
+TEST(ExecutionPool, ExecutionPool_Affinity)
+{
+    std::vector<execq::impl::ITaskProvider*> workers;
+    auto pool = MakePool(2, workers);
+    ASSERT_EQ(workers.size(), 2);
+    
+    MockTaskProvider provider;
+    provider.taskAffinity.set(0x1, std::chrono::hours(1));
+    pool->addProvider(provider);
+    
+    // Worker #1 is out of mask and preferred worker #0 is idle: the provider is not even asked for a task
+    EXPECT_CALL(provider, nextTask())
+    .Times(0);
+    EXPECT_FALSE(workers[1]->nextTask().valid());
+    Mock::VerifyAndClearExpectations(&provider);
+    
+    // Worker #0 is preferred
+    EXPECT_CALL(provider, nextTask())
+    .WillOnce(Invoke(&MakeValidTask));
+    EXPECT_TRUE(workers[0]->nextTask().valid());
+    Mock::VerifyAndClearExpectations(&provider);
+    
+    // Worker #0 is busy now, but not long enough to spill the task to worker #1
+    EXPECT_CALL(provider, nextTask())
+    .Times(0);
+    EXPECT_FALSE(workers[1]->nextTask().valid());
+    Mock::VerifyAndClearExpectations(&provider);
+    
+    pool->removeProvider(provider);
+}
+
+TEST(ExecutionPool, ExecutionPool_Affinity_Spill)
+{
+    std::vector<execq::impl::ITaskProvider*> workers;
+    auto pool = MakePool(2, workers);
+    ASSERT_EQ(workers.size(), 2);
+    
+    MockTaskProvider provider;
+    provider.taskAffinity.set(0x1, std::chrono::milliseconds(0));
+    pool->addProvider(provider);
+    
+    EXPECT_CALL(provider, nextTask())
+    .WillRepeatedly(Invoke(&MakeValidTask));
+    
+    // Make preferred worker #0 busy
+    EXPECT_TRUE(workers[0]->nextTask().valid());
+    
+    // All preferred workers are busy longer than threshold, so the task spills to worker #1
+    EXPECT_TRUE(workers[1]->nextTask().valid());
+    
+    // Mask that doesn't match any pool thread doesn't restrict anything
+    provider.taskAffinity.set(0x4, std::chrono::hours(1));
+    EXPECT_TRUE(workers[1]->nextTask().valid());
+    
+    pool->removeProvider(provider);
+}
+
+TEST(ExecutionPool, ExecutionPool_Affinity_RealThreads)
+{
+    auto pool = execq::CreateExecutionPool(4);
+    
+    std::atomic<size_t> executedCount { 0 };
+    auto queue = execq::CreateConcurrentExecutionQueue<int, void>(pool, [&] (const std::atomic_bool&, int&&) {
+        executedCount++;
+    });
+    queue->setAffinity(0x8, std::chrono::milliseconds(10));
+    
+    // The only preferred worker is idle: it must be woken up, not the first worker of the pool
+    std::future<void> result = queue->push(1);
+    ASSERT_EQ(result.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    
+    for (int i = 0; i < 100; i++)
+    {
+        queue->push(i);
+    }
+    
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (executedCount < 101 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(executedCount, 101);
+}
+
+TEST(ExecutionPool, ExecutionPool_Affinity_RealThreads_Spill)
+{
+    auto pool = execq::CreateExecutionPool(2);
+    
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> releaseFuture = release.get_future().share();
+    auto queue = execq::CreateConcurrentExecutionQueue<int, void>(pool, [&] (const std::atomic_bool&, int&& object) {
+        if (object < 0)
+        {
+            started.set_value();
+            releaseFuture.wait();
+        }
+    });
+    const std::chrono::milliseconds spillThreshold(200);
+    queue->setAffinity(0x1, spillThreshold);
+    
+    // The only preferred worker is blocked: the object is processed anyway, but not before the spill threshold
+    std::future<void> blocked = queue->push(-1);
+    ASSERT_EQ(started.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    
+    std::future<void> result = queue->push(1);
+    EXPECT_EQ(result.wait_for(spillThreshold / 2), std::future_status::timeout);
+    EXPECT_EQ(result.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    
+    release.set_value();
+    blocked.wait();
+}
+
+TEST(ExecutionPool, ExecutionPool_Affinity_RealThreads_SpillThresholds)
+{
+    auto pool = execq::CreateExecutionPool(2);
+    
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> releaseFuture = release.get_future().share();
+    auto slowQueue = execq::CreateConcurrentExecutionQueue<int, void>(pool, [&] (const std::atomic_bool&, int&& object) {
+        if (object < 0)
+        {
+            started.set_value();
+            releaseFuture.wait();
+        }
+    });
+    slowQueue->setAffinity(0x1, std::chrono::hours(1));
+    
+    // The only preferred worker is blocked: long spill check is pending for the next object
+    std::future<void> blocked = slowQueue->push(-1);
+    ASSERT_EQ(started.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    std::future<void> pending = slowQueue->push(1);
+    
+    // Pending long check doesn't delay the shorter one
+    auto queue = execq::CreateConcurrentExecutionQueue<int, void>(pool, [] (const std::atomic_bool&, int&&) {});
+    queue->setAffinity(0x1, std::chrono::milliseconds(10));
+    std::future<void> result = queue->push(1);
+    EXPECT_EQ(result.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    
+    release.set_value();
+    blocked.wait();
+    pending.wait();
+}
+
+TEST(ExecutionPool, ExecutionPool_Affinity_DispatchSyncStaysBusy)
+{
+    auto pool = execq::CreateExecutionPool(3);
+    
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> releaseFuture = release.get_future().share();
+    auto blockedQueue = execq::CreateSerialExecutionQueue<int, int>(pool, [&] (const std::atomic_bool&, int&& object) {
+        if (object < 0)
+        {
+            started.set_value();
+            releaseFuture.wait();
+        }
+        return object;
+    });
+    blockedQueue->setAffinity(0x2, std::chrono::hours(1));
+    
+    std::future<int> blocked = blockedQueue->push(-1);
+    ASSERT_EQ(started.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    
+    // Worker #0 waits in 'dispatchSync' for the blocked serial queue
+    auto callerQueue = execq::CreateConcurrentExecutionQueue<int, int>(pool, [&] (const std::atomic_bool&, int&& object) {
+        return blockedQueue->dispatchSync(std::move(object));
+    });
+    callerQueue->setAffinity(0x1, std::chrono::hours(1));
+    std::future<int> dispatched = callerQueue->push(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    
+    // Waiting worker is still busy: the task spills to the free worker #2
+    auto queue = execq::CreateConcurrentExecutionQueue<int, void>(pool, [] (const std::atomic_bool&, int&&) {});
+    queue->setAffinity(0x1, std::chrono::milliseconds(10));
+    std::future<void> result = queue->push(1);
+    EXPECT_EQ(result.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    
+    release.set_value();
+    EXPECT_EQ(blocked.get(), -1);
+    EXPECT_EQ(dispatched.get(), 1);
+}
@@ -280,3 +280,637 @@ TEST(ExecutionPool, ExecutionQueue_Cancelability)
     EXPECT_CALL(*executionPool, removeProvider(::testing::_))
     .WillOnce(::testing::Return());
 }
+
+TEST(ExecutionPool, ExecutionQueue_Rebind)
+{
+    auto oldPool = std::make_shared<MockExecutionPool>();
+    auto newPool = std::make_shared<MockExecutionPool>();
+    MockThreadWorkerFactory workerFactory {};
+    
+    //  Queue must 'register' itself in ExecutionPool when created
+    execq::impl::ITaskProvider* registeredProvider = nullptr;
+    EXPECT_CALL(*oldPool, addProvider(SaveArgAddress(&registeredProvider)))
+    .WillOnce(::testing::Return());
+    
+    std::unique_ptr<MockThreadWorker> additionalWorkerPtr(new MockThreadWorker{});
+    EXPECT_CALL(workerFactory, createWorker(::testing::_))
+    .WillOnce(::testing::Return(::testing::ByMove(std::move(additionalWorkerPtr))));
+    
+    ::testing::MockFunction<void(const std::atomic_bool&, std::string&&)> mockExecutor;
+    execq::impl::ExecutionQueue<std::string, void> queue(true, oldPool, workerFactory, mockExecutor.AsStdFunction());
+    ASSERT_NE(registeredProvider, nullptr);
+    
+    EXPECT_CALL(*oldPool, notifyOneWorker())
+    .WillOnce(::testing::Return(true));
+    queue.push("qwe");
+    queue.push("asd");
+    
+    
+    // When rebound, queue registers in the new pool, unregisters from the old one and notifies new pool about pending tasks
+    execq::impl::ITaskProvider* reboundProvider = nullptr;
+    EXPECT_CALL(*newPool, addProvider(SaveArgAddress(&reboundProvider)))
+    .WillOnce(::testing::Return());
+    EXPECT_CALL(*oldPool, removeProvider(::testing::_))
+    .WillOnce(::testing::Return());
+    EXPECT_CALL(*newPool, notifyOneWorker())
+    .WillOnce(::testing::Return(true));
+    queue.rebind(newPool);
+    EXPECT_EQ(reboundProvider, registeredProvider);
+    
+    
+    // Pending tasks are kept in the same order
+    execq::impl::Task task = reboundProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    EXPECT_CALL(mockExecutor, Call(CompareWithAtomic(false), CompareRvalue("qwe")))
+    .WillOnce(::testing::Return());
+    EXPECT_CALL(*newPool, notifyOneWorker())
+    .WillOnce(::testing::Return(true));
+    task();
+    
+    task = reboundProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    EXPECT_CALL(mockExecutor, Call(CompareWithAtomic(false), CompareRvalue("asd")))
+    .WillOnce(::testing::Return());
+    task();
+    
+    
+    //  Queue must 'unregister' itself from the new pool when destroyed
+    EXPECT_CALL(*newPool, removeProvider(::testing::_))
+    .WillOnce(::testing::Return());
+}
+
+TEST(ExecutionPool, ExecutionQueue_Rebind_RealPools)
+{
+    auto pool1 = execq::CreateExecutionPool();
+    auto pool2 = execq::CreateExecutionPool();
+    
+    std::vector<uint32_t> processed;
+    auto queue = execq::CreateSerialExecutionQueue<uint32_t, void>(pool1, [&processed] (const std::atomic_bool&, uint32_t&& object) {
+        processed.push_back(object);
+    });
+    
+    const uint32_t count = 1000;
+    std::future<void> last;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        last = queue->push(i);
+        if (i % 100 == 0)
+        {
+            queue->rebind(i % 200 ? pool1 : pool2);
+        }
+    }
+    
+    ASSERT_TRUE(last.wait_for(kTimeout) == std::future_status::ready);
+    ASSERT_EQ(processed.size(), count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(processed[i], i);
+    }
+}
+
+TEST(ExecutionPool, ExecutionQueue_LocalityKey)
+{
+    auto executionPool = std::make_shared<MockExecutionPool>();
+    MockThreadWorkerFactory workerFactory {};
+    
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .WillRepeatedly(::testing::Return(true));
+    
+    execq::impl::ITaskProvider* registeredProvider = nullptr;
+    EXPECT_CALL(*executionPool, addProvider(SaveArgAddress(&registeredProvider)))
+    .WillOnce(::testing::Return());
+    
+    std::unique_ptr<MockThreadWorker> additionalWorkerPtr(new MockThreadWorker{});
+    EXPECT_CALL(workerFactory, createWorker(::testing::_))
+    .WillOnce(::testing::Return(::testing::ByMove(std::move(additionalWorkerPtr))));
+    
+    
+    // Objects are keyed by their first letter
+    std::vector<std::string> processed;
+    execq::impl::ExecutionQueue<std::string, void> queue(false, executionPool, workerFactory, [&processed] (const std::atomic_bool&, std::string&& object) {
+        processed.push_back(object);
+    });
+    queue.setLocalityKey([] (const std::string& object) { return static_cast<size_t>(object[0]); }, 2);
+    ASSERT_NE(registeredProvider, nullptr);
+    
+    queue.push("a1");
+    queue.push("b1");
+    queue.push("a2");
+    queue.push("c1");
+    queue.push("a3");
+    
+    
+    // The first task processes the object and then same-key objects within the window.
+    execq::impl::Task task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    EXPECT_EQ(processed, std::vector<std::string>({ "a1", "a2" }));
+    
+    // 'a3' is out of window when 'a2' is processed
+    task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    EXPECT_EQ(processed, std::vector<std::string>({ "a1", "a2", "b1" }));
+    
+    task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    EXPECT_EQ(processed, std::vector<std::string>({ "a1", "a2", "b1", "c1" }));
+    
+    task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    EXPECT_EQ(processed, std::vector<std::string>({ "a1", "a2", "b1", "c1", "a3" }));
+    
+    
+    // All objects are processed: no more tasks
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    
+    EXPECT_CALL(*executionPool, removeProvider(::testing::_))
+    .WillOnce(::testing::Return());
+}
+
+TEST(ExecutionPool, ExecutionQueue_Prefetch)
+{
+    auto executionPool = std::make_shared<MockExecutionPool>();
+    MockThreadWorkerFactory workerFactory {};
+    
+    EXPECT_CALL(*executionPool, notifyOneWorker())
+    .WillRepeatedly(::testing::Return(true));
+    
+    execq::impl::ITaskProvider* registeredProvider = nullptr;
+    EXPECT_CALL(*executionPool, addProvider(SaveArgAddress(&registeredProvider)))
+    .WillOnce(::testing::Return());
+    
+    std::unique_ptr<MockThreadWorker> additionalWorkerPtr(new MockThreadWorker{});
+    EXPECT_CALL(workerFactory, createWorker(::testing::_))
+    .WillOnce(::testing::Return(::testing::ByMove(std::move(additionalWorkerPtr))));
+    
+    ::testing::MockFunction<void(const std::atomic_bool&, std::string&&)> mockExecutor;
+    execq::impl::ExecutionQueue<std::string, void> queue(false, executionPool, workerFactory, mockExecutor.AsStdFunction());
+    ASSERT_NE(registeredProvider, nullptr);
+    
+    ::testing::MockFunction<void(const std::string&)> mockPrefetch;
+    queue.setPrefetch(mockPrefetch.AsStdFunction());
+    
+    queue.push("qwe");
+    queue.push("asd");
+    
+    
+    // When the object is taken for processing, the next pending object is prefetched before the executor is called.
+    // The hook is called without the lock, so it may even push into the queue.
+    ::testing::InSequence sequence;
+    EXPECT_CALL(mockPrefetch, Call("asd"))
+    .WillOnce(::testing::Invoke([&queue] (const std::string&) {
+        queue.push("zxc");
+    }));
+    EXPECT_CALL(mockExecutor, Call(::testing::_, CompareRvalue("qwe")))
+    .WillOnce(::testing::Return());
+    
+    // Prefetched objects are processed on the same thread, right after the current one
+    EXPECT_CALL(mockPrefetch, Call("zxc"))
+    .WillOnce(::testing::Return());
+    EXPECT_CALL(mockExecutor, Call(::testing::_, CompareRvalue("asd")))
+    .WillOnce(::testing::Return());
+    EXPECT_CALL(mockExecutor, Call(::testing::_, CompareRvalue("zxc")))
+    .WillOnce(::testing::Return());
+    
+    execq::impl::Task task = registeredProvider->nextTask();
+    ASSERT_TRUE(task.valid());
+    task();
+    
+    
+    // All objects are processed by single task
+    EXPECT_FALSE(registeredProvider->nextTask().valid());
+    
+    EXPECT_CALL(*executionPool, removeProvider(::testing::_))
+    .WillOnce(::testing::Return());
+}
+
+namespace
+{
+    struct NonMovableObject
+    {
+        explicit NonMovableObject(const int value)
+        : value(value)
+        {}
+        
+        NonMovableObject(const NonMovableObject&) = delete;
+        NonMovableObject& operator=(const NonMovableObject&) = delete;
+        
+        int value = 0;
+    };
+}
+
+TEST(ExecutionPool, ExecutionQueue_ZeroCopyPush)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    auto queue = execq::CreateConcurrentExecutionQueue<NonMovableObject, const NonMovableObject*>(pool, [] (const std::atomic_bool&, NonMovableObject&& object) {
+        return &object;
+    });
+    
+    // Object pushed by unique_ptr is processed at the same address
+    std::unique_ptr<NonMovableObject> uniqueObject(new NonMovableObject(1));
+    const NonMovableObject* uniqueAddress = uniqueObject.get();
+    EXPECT_EQ(queue->push(std::move(uniqueObject)).get(), uniqueAddress);
+    
+    // Queue keeps shared object alive until it is processed and then drops its reference
+    std::shared_ptr<NonMovableObject> sharedObject = std::make_shared<NonMovableObject>(2);
+    EXPECT_EQ(queue->push(sharedObject).get(), sharedObject.get());
+    queue.reset();
+    EXPECT_EQ(sharedObject.use_count(), 1);
+}
+
+TEST(ExecutionPool, ExecutionQueue_BorrowedPush)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    auto queue = execq::CreateSerialExecutionQueue<NonMovableObject, int>(pool, [] (const std::atomic_bool&, NonMovableObject&& object) {
+        return object.value;
+    });
+    
+    NonMovableObject borrowedObject(3);
+    std::promise<const NonMovableObject*> released;
+    std::future<int> result = queue->pushBorrowed(borrowedObject, [&released] (NonMovableObject& object) {
+        released.set_value(&object);
+    });
+    
+    EXPECT_EQ(result.get(), 3);
+    
+    std::future<const NonMovableObject*> releasedObject = released.get_future();
+    ASSERT_TRUE(releasedObject.wait_for(kTimeout) == std::future_status::ready);
+    EXPECT_EQ(releasedObject.get(), &borrowedObject);
+    
+    EXPECT_THROW(queue->push(std::unique_ptr<NonMovableObject>()), std::invalid_argument);
+    
+    // Borrowed object is never deleted by the queue, so it can't be pushed without release function
+    EXPECT_THROW(queue->pushBorrowed(borrowedObject, nullptr), std::invalid_argument);
+}
+
+TEST(ExecutionPool, ExecutionQueue_ObjectPtr)
+{
+    // Owned objects cost no more than std::unique_ptr
+    static_assert(sizeof(execq::impl::ObjectPtr<NonMovableObject>) == sizeof(std::unique_ptr<NonMovableObject>), "");
+    static_assert(sizeof(execq::impl::ObjectPtr<char>) == sizeof(std::unique_ptr<char>), "");
+    
+    // Owned object is kept as is
+    NonMovableObject* ownedObject = new NonMovableObject(1);
+    execq::impl::ObjectPtr<NonMovableObject> owned { std::unique_ptr<NonMovableObject>(ownedObject) };
+    EXPECT_EQ(owned.get(), ownedObject);
+    
+    // Borrowed object is returned, not deleted
+    NonMovableObject borrowedObject(2);
+    bool released = false;
+    {
+        execq::impl::ObjectPtr<NonMovableObject> borrowed(new execq::impl::BorrowedObjectReleaser<NonMovableObject>(borrowedObject, [&released] (NonMovableObject&) {
+            released = true;
+        }));
+        EXPECT_EQ(borrowed.get(), &borrowedObject);
+    }
+    EXPECT_TRUE(released);
+    
+    // Shared object is released by dropping the reference
+    std::shared_ptr<NonMovableObject> sharedObject = std::make_shared<NonMovableObject>(3);
+    execq::impl::ObjectPtr<NonMovableObject> shared(new execq::impl::SharedObjectReleaser<NonMovableObject>(sharedObject));
+    EXPECT_EQ(shared.get(), sharedObject.get());
+    EXPECT_EQ(sharedObject.use_count(), 2);
+    shared.reset();
+    EXPECT_EQ(sharedObject.use_count(), 1);
+}
+
+TEST(ExecutionPool, ExecutionQueue_Target)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    std::atomic_bool isRunning { false };
+    std::atomic_int processedCount { 0 };
+    auto executor = [&] (const std::atomic_bool&, int&&) {
+        // Serial target lets only one task of the whole hierarchy run at a time
+        EXPECT_FALSE(isRunning.exchange(true));
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        isRunning = false;
+        processedCount++;
+    };
+    
+    auto target = execq::CreateSerialExecutionQueue<int, void>(pool, executor);
+    auto middle = execq::CreateConcurrentExecutionQueue<int, void>(pool, executor);
+    middle->setTarget(*target);
+    
+    std::vector<std::unique_ptr<execq::IExecutionQueue<void(int)>>> queues;
+    for (int i = 0; i < 4; i++)
+    {
+        queues.push_back(execq::CreateConcurrentExecutionQueue<int, void>(pool, executor));
+        queues.back()->setTarget(i % 2 ? *target : *middle);
+    }
+    
+    const int countPerQueue = 50;
+    std::vector<std::future<void>> results;
+    for (int i = 0; i < countPerQueue; i++)
+    {
+        results.push_back(target->push(i));
+        results.push_back(middle->push(i));
+        for (const auto& queue : queues)
+        {
+            results.push_back(queue->push(i));
+        }
+    }
+    
+    for (auto& result : results)
+    {
+        ASSERT_EQ(result.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    }
+    EXPECT_EQ(processedCount, countPerQueue * 6);
+    
+    queues.clear();
+    middle.reset();
+}
+
+TEST(ExecutionPool, ExecutionQueue_Target_Cycle)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    auto executor = [] (const std::atomic_bool&, int&&) {};
+    auto target = execq::CreateSerialExecutionQueue<int, void>(pool, executor);
+    auto middle = execq::CreateConcurrentExecutionQueue<int, void>(pool, executor);
+    auto timed = execq::CreateDebouncedExecutionQueue<int, void>(pool, std::chrono::milliseconds(1), executor);
+    middle->setTarget(*target);
+    timed->setTarget(*middle);
+    
+    EXPECT_THROW(target->setTarget(*target), std::invalid_argument);
+    EXPECT_THROW(target->setTarget(*middle), std::invalid_argument);
+    EXPECT_THROW(target->setTarget(*timed), std::invalid_argument);
+    EXPECT_THROW(timed->setTarget(*timed), std::invalid_argument);
+    
+    // Rejected targets are not set: the hierarchy still works
+    EXPECT_NO_THROW(timed->push(1).get());
+    EXPECT_NO_THROW(target->push(1).get());
+}
+
+TEST(ExecutionPool, ExecutionQueue_DispatchSync)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    std::atomic<std::thread::id> executedOn;
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> releaseFuture = release.get_future().share();
+    auto queue = execq::CreateSerialExecutionQueue<int, int>(pool, [&] (const std::atomic_bool&, int&& object) {
+        executedOn = std::this_thread::get_id();
+        if (object < 0)
+        {
+            started.set_value();
+            releaseFuture.wait();
+        }
+        return object * 2;
+    });
+    
+    // Idle queue executes the object on the calling thread
+    EXPECT_EQ(queue->dispatchSync(1), 2);
+    EXPECT_EQ(executedOn, std::this_thread::get_id());
+    
+    // Busy queue: the object waits for its turn
+    std::future<int> busy = queue->push(-1);
+    ASSERT_EQ(started.get_future().wait_for(kTimeout), std::future_status::ready);
+    
+    std::future<int> dispatched = std::async(std::launch::async, [&] {
+        return queue->dispatchSync(3);
+    });
+    EXPECT_EQ(dispatched.wait_for(std::chrono::milliseconds(10)), std::future_status::timeout);
+    
+    release.set_value();
+    EXPECT_EQ(busy.get(), -2);
+    EXPECT_EQ(dispatched.get(), 6);
+}
+
+TEST(ExecutionPool, ExecutionQueue_DispatchSync_FromPool)
+{
+    auto pool = execq::CreateExecutionPool(2);
+    
+    auto serialQueue = execq::CreateSerialExecutionQueue<int, int>(pool, [] (const std::atomic_bool&, int&& object) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return object;
+    });
+    
+    // Every pool thread waits in 'dispatchSync': waiting threads help, nothing hangs
+    std::atomic_int sum { 0 };
+    auto callerQueue = execq::CreateConcurrentExecutionQueue<int, void>(pool, [&] (const std::atomic_bool&, int&& object) {
+        sum += serialQueue->dispatchSync(object);
+    });
+    
+    std::vector<std::future<void>> results;
+    for (int i = 1; i <= 20; i++)
+    {
+        results.push_back(callerQueue->push(i));
+    }
+    
+    for (auto& result : results)
+    {
+        ASSERT_EQ(result.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    }
+    EXPECT_EQ(sum, 210);
+}
+
+TEST(ExecutionPool, ExecutionQueue_DispatchSync_FromSerialQueue)
+{
+    auto pool = execq::CreateExecutionPool(2);
+    
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> releaseFuture = release.get_future().share();
+    // Pool-independent: the object is executed on the queue's own thread, so pool threads stay free
+    auto busyQueue = execq::CreateSerialExecutionQueue<int, int>([&] (const std::atomic_bool&, int&& object) {
+        if (object < 0)
+        {
+            started.set_value();
+            releaseFuture.wait();
+        }
+        return object;
+    });
+    busyQueue->push(-1);
+    ASSERT_EQ(started.get_future().wait_for(kTimeout), std::future_status::ready);
+    
+    std::unique_ptr<execq::IExecutionQueue<int(int)>> serialQueue;
+    auto callerQueue = execq::CreateConcurrentExecutionQueue<int, int>(pool, [&] (const std::atomic_bool&, int&& object) {
+        return serialQueue->dispatchSync(object);
+    });
+    
+    std::vector<std::future<int>> callerResults;
+    serialQueue = execq::CreateSerialExecutionQueue<int, int>(pool, [&] (const std::atomic_bool&, int&& object) {
+        if (object == 0)
+        {
+            for (int i = 1; i <= 20; i++)
+            {
+                callerResults.push_back(callerQueue->push(i));
+            }
+            
+            // Thread that owns serial queue must not help: helped task would wait for the serial queue forever
+            return busyQueue->dispatchSync(0);
+        }
+        return object;
+    });
+    
+    std::future<int> result = serialQueue->push(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    release.set_value();
+    
+    ASSERT_EQ(result.wait_for(kTimeout), std::future_status::ready);
+    EXPECT_EQ(result.get(), 0);
+    for (size_t i = 0; i < callerResults.size(); i++)
+    {
+        ASSERT_EQ(callerResults[i].wait_for(kTimeout), std::future_status::ready);
+        EXPECT_EQ(callerResults[i].get(), i + 1);
+    }
+}
+
+TEST(ExecutionPool, ExecutionQueue_TryPushRealtime)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> releaseFuture = release.get_future().share();
+    std::promise<void> finished;
+    std::vector<int> processed;
+    auto queue = execq::CreateSerialExecutionQueue<int, void>(pool, [&] (const std::atomic_bool&, int&& object) {
+        if (object < 0)
+        {
+            started.set_value();
+            releaseFuture.wait();
+            return;
+        }
+        
+        processed.push_back(object);
+        if (processed.size() == 4)
+        {
+            finished.set_value();
+        }
+    });
+    
+    // Slots are not reserved yet
+    EXPECT_FALSE(queue->tryPushRealtime(1));
+    
+    queue->reserveRealtime(4);
+    
+    // Serial queue is busy, so objects stay in the slots
+    std::future<void> busy = queue->push(-1);
+    ASSERT_EQ(started.get_future().wait_for(kTimeout), std::future_status::ready);
+    
+    EXPECT_TRUE(queue->tryPushRealtime(1));
+    EXPECT_TRUE(queue->tryPushRealtime(2));
+    EXPECT_TRUE(queue->tryPushRealtime(3));
+    EXPECT_TRUE(queue->tryPushRealtime(4));
+    EXPECT_FALSE(queue->tryPushRealtime(5));
+    
+    release.set_value();
+    
+    // Realtime objects are processed in order of pushing
+    ASSERT_EQ(finished.get_future().wait_for(kTimeout), std::future_status::ready);
+    EXPECT_EQ(processed, std::vector<int>({ 1, 2, 3, 4 }));
+}
+
+TEST(ExecutionPool, ExecutionQueue_TryPushRealtime_DispatchSync)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> releaseFuture = release.get_future().share();
+    std::vector<int> processed;
+    auto queue = execq::CreateSerialExecutionQueue<int, int>(pool, [&] (const std::atomic_bool&, int&& object) {
+        if (object < 0)
+        {
+            started.set_value();
+            releaseFuture.wait();
+        }
+        else
+        {
+            processed.push_back(object);
+        }
+        return object;
+    });
+    queue->reserveRealtime(4);
+    
+    std::future<int> busy = queue->push(-1);
+    ASSERT_EQ(started.get_future().wait_for(kTimeout), std::future_status::ready);
+    
+    EXPECT_TRUE(queue->tryPushRealtime(1));
+    EXPECT_TRUE(queue->tryPushRealtime(2));
+    
+    // Object dispatched after realtime objects is processed after them
+    std::future<int> dispatched = std::async(std::launch::async, [&] {
+        return queue->dispatchSync(3);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    release.set_value();
+    
+    ASSERT_EQ(dispatched.wait_for(kTimeout), std::future_status::ready);
+    EXPECT_EQ(dispatched.get(), 3);
+    EXPECT_EQ(processed, std::vector<int>({ 1, 2, 3 }));
+}
+
+TEST(ExecutionPool, ExecutionQueue_TryPushRealtime_MultipleProducers)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    std::atomic_int sum { 0 };
+    std::atomic_int count { 0 };
+    auto queue = execq::CreateConcurrentExecutionQueue<int, void>(pool, [&] (const std::atomic_bool&, int&& object) {
+        sum += object;
+        count++;
+    });
+    queue->reserveRealtime(16);
+    
+    const int objectCount = 1000;
+    auto producer = [&] {
+        for (int i = 1; i <= objectCount; i++)
+        {
+            while (!queue->tryPushRealtime(int(i)))
+            {
+                std::this_thread::yield();
+            }
+        }
+    };
+    
+    std::thread producer1(producer);
+    std::thread producer2(producer);
+    producer1.join();
+    producer2.join();
+    
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (count < 2 * objectCount && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    
+    EXPECT_EQ(count, 2 * objectCount);
+    EXPECT_EQ(sum, objectCount * (objectCount + 1));
+}
+
+namespace
+{
+    struct MoveOnlyExecutor
+    {
+        std::unique_ptr<int> factor;
+        
+        std::unique_ptr<int> operator()(const std::atomic_bool&, std::unique_ptr<int>&& object)
+        {
+            return std::unique_ptr<int>(new int(*object * *factor));
+        }
+    };
+}
+
+TEST(ExecutionPool, ExecutionQueue_MoveOnly)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    // Executor owns move-only state and produces move-only results
+    MoveOnlyExecutor executor { std::unique_ptr<int>(new int(3)) };
+    auto queue = execq::CreateSerialExecutionQueue<std::unique_ptr<int>, std::unique_ptr<int>>(pool, std::move(executor));
+    
+    std::future<std::unique_ptr<int>> result = queue->push(std::unique_ptr<int>(new int(2)));
+    ASSERT_EQ(result.wait_for(kTimeout), std::future_status::ready);
+    EXPECT_EQ(*result.get(), 6);
+    
+    EXPECT_EQ(*queue->dispatchSync(std::unique_ptr<int>(new int(5))), 15);
+}
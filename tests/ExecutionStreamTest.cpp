@@ -27,6 +27,8 @@
 #include "ExecutionStream.h"
 #include "ExecqTestUtil.h"
 
+#include <set>
+
 using namespace execq::test;
 
 TEST(ExecutionPool, ExecutionStream_UsualRun)
@@ -113,3 +115,97 @@ TEST(ExecutionPool, ExecutionStream_WorkerPool)
     EXPECT_CALL(*executionPool, removeProvider(::testing::_))
     .WillOnce(::testing::Return());
 }
+
+TEST(ExecutionPool, ExecutionStream_Affinity_Spill)
+{
+    auto pool = execq::CreateExecutionPool(2);
+    
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> releaseFuture = release.get_future().share();
+    auto blockingQueue = execq::CreateConcurrentExecutionQueue<int, void>(pool, [&] (const std::atomic_bool&, int&&) {
+        started.set_value();
+        releaseFuture.wait();
+    });
+    blockingQueue->setAffinity(0x1, std::chrono::hours(1));
+    
+    // The only preferred worker is blocked
+    std::future<void> blocked = blockingQueue->push(0);
+    ASSERT_EQ(started.get_future().wait_for(kTimeout), std::future_status::ready);
+    
+    std::mutex threadsMutex;
+    std::set<std::thread::id> threads;
+    auto stream = execq::CreateExecutionStream(pool, [&] (const std::atomic_bool&) {
+        {
+            std::lock_guard<std::mutex> lock(threadsMutex);
+            threads.insert(std::this_thread::get_id());
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    const std::chrono::milliseconds spillThreshold(100);
+    stream->setAffinity(0x1, spillThreshold);
+    stream->start();
+    
+    // Only the stream's additional worker executes it until the spill threshold...
+    std::this_thread::sleep_for(spillThreshold / 2);
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        EXPECT_EQ(threads.size(), 1);
+    }
+    
+    // ...then the other pool worker joins
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        {
+            std::lock_guard<std::mutex> lock(threadsMutex);
+            if (threads.size() > 1)
+            {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    
+    stream->stop();
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        EXPECT_EQ(threads.size(), 2);
+    }
+    
+    release.set_value();
+    blocked.wait();
+}
+
+namespace
+{
+    struct MoveOnlyExecutee
+    {
+        std::unique_ptr<std::atomic_int> executedCount;
+        
+        void operator()(const std::atomic_bool&)
+        {
+            (*executedCount)++;
+        }
+    };
+}
+
+TEST(ExecutionPool, ExecutionStream_MoveOnly)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    // Executee owns move-only state
+    std::unique_ptr<std::atomic_int> executedCount(new std::atomic_int(0));
+    const std::atomic_int& executedCountRef = *executedCount;
+    auto stream = execq::CreateExecutionStream(pool, MoveOnlyExecutee { std::move(executedCount) });
+    
+    stream->start();
+    const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+    while (!executedCountRef && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+    stream->stop();
+    
+    EXPECT_GT(executedCountRef, 0);
+}
@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    std::string Trim(const std::atomic_bool&, std::string&& object)
+    {
+        const size_t first = object.find_first_not_of(' ');
+        const size_t last = object.find_last_not_of(' ');
+        return first == std::string::npos ? std::string() : object.substr(first, last - first + 1);
+    }
+    
+    size_t Length(const std::atomic_bool&, std::string&& object)
+    {
+        return object.size();
+    }
+}
+
+TEST(ExecutionPool, FusedStage_Chain)
+{
+    const std::atomic_bool canceled { false };
+    
+    auto fused = execq::Fuse(&Trim, &Length, [] (const std::atomic_bool& isCanceled, size_t&& object) {
+        return isCanceled ? 0 : object * 2;
+    });
+    
+    EXPECT_EQ(fused(canceled, std::string("  abc ")), 6);
+    EXPECT_EQ(fused(canceled, std::string("   ")), 0);
+    
+    // Move-only objects are passed from stage to stage
+    auto moveOnly = execq::Fuse([] (const std::atomic_bool&, std::unique_ptr<int>&& object) {
+        (*object)++;
+        return std::move(object);
+    }, [] (const std::atomic_bool&, std::unique_ptr<int>&& object) {
+        return *object;
+    });
+    
+    EXPECT_EQ(moveOnly(canceled, std::unique_ptr<int>(new int(1))), 2);
+}
+
+TEST(ExecutionPool, FusedStage_Pipeline)
+{
+    std::shared_ptr<execq::IExecutionPool> pool = execq::CreateExecutionPool(2);
+    
+    std::atomic_size_t total { 0 };
+    std::unique_ptr<execq::IPipeline<std::string>> pipeline = execq::PipelineBuilder<std::string>(pool)
+    .parallel<size_t>(4, execq::Fuse(&Trim, &Length))
+    .serial<void>(4, [&] (const std::atomic_bool&, size_t&& object) {
+        total += object;
+    })
+    .build();
+    
+    pipeline->push(" a ");
+    pipeline->push("bb  ");
+    pipeline->push("   ccc");
+    pipeline.reset();
+    
+    EXPECT_EQ(total, 6);
+    
+    
+    auto queue = execq::CreateConcurrentExecutionQueue<std::string, size_t>(pool, execq::Fuse(&Trim, &Length));
+    EXPECT_EQ(queue->push(" abcd ").get(), 4);
+}
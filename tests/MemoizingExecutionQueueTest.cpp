@@ -0,0 +1,164 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+using namespace execq::test;
+
+namespace
+{
+    class Gate
+    {
+    public:
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_opened; });
+        }
+        
+        void open()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_opened = true;
+            m_condition.notify_all();
+        }
+        
+    private:
+        bool m_opened = false;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+    };
+}
+
+TEST(ExecutionPool, MemoizingExecutionQueue_InFlight)
+{
+    auto pool = execq::CreateExecutionPool(4);
+    
+    Gate gate;
+    std::atomic_int executedCount { 0 };
+    auto queue = execq::CreateMemoizingExecutionQueue<std::string, std::string, size_t>(pool, [] (const std::string& object) {
+        return object;
+    }, [&] (const std::atomic_bool&, std::string&& object) {
+        executedCount++;
+        gate.wait();
+        return object.size();
+    });
+    
+    std::vector<std::shared_future<size_t>> futures;
+    for (int i = 0; i < 10; i++)
+    {
+        futures.push_back(queue->push("qwe"));
+    }
+    std::shared_future<size_t> other = queue->push("asdfg");
+    
+    gate.open();
+    
+    for (const auto& future : futures)
+    {
+        ASSERT_EQ(future.wait_for(kTimeout), std::future_status::ready);
+        EXPECT_EQ(future.get(), 3);
+    }
+    ASSERT_EQ(other.wait_for(kTimeout), std::future_status::ready);
+    EXPECT_EQ(other.get(), 5);
+    EXPECT_EQ(executedCount, 2);
+    
+    // Without cache, completed objects are executed again
+    EXPECT_EQ(queue->push("qwe").get(), 3);
+    EXPECT_EQ(executedCount, 3);
+}
+
+TEST(ExecutionPool, MemoizingExecutionQueue_Cache)
+{
+    auto pool = execq::CreateExecutionPool(2);
+    
+    std::atomic_int executedCount { 0 };
+    auto queue = execq::CreateMemoizingExecutionQueue<int, int, int>(pool, [] (const int& object) {
+        return object;
+    }, [&] (const std::atomic_bool&, int&& object) {
+        executedCount++;
+        return object * 2;
+    }, 2, kTimeout);
+    
+    EXPECT_EQ(queue->push(1).get(), 2);
+    EXPECT_EQ(queue->push(2).get(), 4);
+    EXPECT_EQ(executedCount, 2);
+    
+    // Cached
+    EXPECT_EQ(queue->push(1).get(), 2);
+    EXPECT_EQ(executedCount, 2);
+    
+    // '2' is the least recently used and evicted
+    EXPECT_EQ(queue->push(3).get(), 6);
+    EXPECT_EQ(executedCount, 3);
+    EXPECT_EQ(queue->push(1).get(), 2);
+    EXPECT_EQ(executedCount, 3);
+    EXPECT_EQ(queue->push(2).get(), 4);
+    EXPECT_EQ(executedCount, 4);
+    
+    queue->clearCache();
+    EXPECT_EQ(queue->push(2).get(), 4);
+    EXPECT_EQ(executedCount, 5);
+    
+    // Expired
+    std::this_thread::sleep_for(kTimeout);
+    EXPECT_EQ(queue->push(2).get(), 4);
+    EXPECT_EQ(executedCount, 6);
+}
+
+TEST(ExecutionPool, MemoizingExecutionQueue_FailureNotCached)
+{
+    auto pool = execq::CreateExecutionPool(2);
+    
+    std::atomic_int executedCount { 0 };
+    auto queue = execq::CreateMemoizingExecutionQueue<int, int, int>(pool, [] (const int& object) {
+        return object;
+    }, [&] (const std::atomic_bool&, int&& object) {
+        if (executedCount++ == 0)
+        {
+            throw std::runtime_error("failure");
+        }
+        return object * 2;
+    }, 2, kTimeout);
+    
+    std::shared_future<int> failed = queue->push(1);
+    ASSERT_EQ(failed.wait_for(kTimeout), std::future_status::ready);
+    EXPECT_ANY_THROW(failed.get());
+    EXPECT_EQ(executedCount, 1);
+    
+    // Failure is dropped, the object is executed again and the success is cached
+    EXPECT_EQ(queue->push(1).get(), 2);
+    EXPECT_EQ(executedCount, 2);
+    EXPECT_EQ(queue->push(1).get(), 2);
+    EXPECT_EQ(executedCount, 2);
+}
+
+TEST(ExecutionPool, MemoizingExecutionQueue_NullPool)
+{
+    EXPECT_THROW((execq::CreateMemoizingExecutionQueue<int, int, int>(nullptr, [] (const int& object) {
+        return object;
+    }, [] (const std::atomic_bool&, int&& object) {
+        return object;
+    })), std::invalid_argument);
+}
@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+#include <set>
+
+using namespace execq::test;
+
+TEST(ExecutionPool, ObjectRecycler_Reuse)
+{
+    execq::ObjectRecycler<std::vector<char>> recycler;
+    
+    // Recycler has no objects, so new one is created with given arguments
+    execq::RecycledPtr<std::vector<char>> buffer = recycler.acquire(1024);
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_EQ(buffer->size(), 1024);
+    const std::vector<char>* bufferAddress = buffer.get();
+    
+    // When released, the object returns to the recycler and reused as is
+    buffer.reset();
+    buffer = recycler.acquire(1);
+    EXPECT_EQ(buffer.get(), bufferAddress);
+    EXPECT_EQ(buffer->size(), 1024);
+    
+    // While the object is in use, new objects are created
+    execq::RecycledPtr<std::vector<char>> buffer2 = recycler.acquire(1);
+    EXPECT_NE(buffer2.get(), bufferAddress);
+    EXPECT_EQ(buffer2->size(), 1);
+}
+
+TEST(ExecutionPool, ObjectRecycler_Queue)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    auto queue = execq::CreateConcurrentExecutionQueue<std::vector<char>, size_t>(pool, [] (const std::atomic_bool&, std::vector<char>&& buffer) {
+        return buffer.size();
+    });
+    
+    std::unique_ptr<execq::ObjectRecycler<std::vector<char>>> recycler(new execq::ObjectRecycler<std::vector<char>>());
+    std::set<const std::vector<char>*> allocated;
+    
+    const size_t count = 100;
+    for (size_t i = 0; i < count; i++)
+    {
+        execq::RecycledPtr<std::vector<char>> buffer = recycler->acquire(64);
+        allocated.insert(buffer.get());
+        queue->push(std::move(buffer));
+    }
+    
+    // Wait until all objects are processed and returned from pool threads
+    queue.reset();
+    
+    // Now all objects are reused
+    std::vector<execq::RecycledPtr<std::vector<char>>> buffers;
+    for (size_t i = 0; i < allocated.size(); i++)
+    {
+        buffers.push_back(recycler->acquire(64));
+        EXPECT_TRUE(allocated.count(buffers.back().get()));
+    }
+}
+
+TEST(ExecutionPool, ObjectRecycler_DestroyedBeforeObjects)
+{
+    auto pool = execq::CreateExecutionPool();
+    
+    auto queue = execq::CreateSerialExecutionQueue<std::vector<char>, size_t>(pool, [] (const std::atomic_bool&, std::vector<char>&& buffer) {
+        WaitForLongTermJob();
+        return buffer.size();
+    });
+    
+    std::unique_ptr<execq::ObjectRecycler<std::vector<char>>> recycler(new execq::ObjectRecycler<std::vector<char>>());
+    std::future<size_t> result = queue->push(recycler->acquire(64));
+    
+    // Objects being processed keep recycler's internals alive
+    recycler.reset();
+    EXPECT_EQ(result.get(), 64);
+}
@@ -0,0 +1,119 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+#include <gtest/gtest.h>
+
+TEST(ExecutionPool, OrderedExecutionQueue_Order)
+{
+    std::shared_ptr<execq::IExecutionPool> pool = execq::CreateExecutionPool(4);
+    
+    std::vector<int> results;
+    std::atomic_int concurrentCount { 0 };
+    bool overlapped = false;
+    
+    auto queue = execq::CreateOrderedExecutionQueue<int, int>(pool, 8, [] (const std::atomic_bool&, int&& object) {
+        // Earlier objects are processed longer
+        std::this_thread::sleep_for(std::chrono::microseconds((10 - object % 10) * 100));
+        return object;
+    }, [&] (int&& result) {
+        overlapped |= concurrentCount++ != 0;
+        results.push_back(result);
+        concurrentCount--;
+    });
+    
+    for (int i = 0; i < 100; i++)
+    {
+        queue->push(int(i));
+    }
+    
+    queue.reset();
+    
+    EXPECT_FALSE(overlapped);
+    ASSERT_EQ(results.size(), 100);
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(results[i], i);
+    }
+}
+
+TEST(ExecutionPool, OrderedExecutionQueue_Backpressure)
+{
+    std::shared_ptr<execq::IExecutionPool> pool = execq::CreateExecutionPool(4);
+    
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool released = false;
+    std::atomic_size_t processedCount { 0 };
+    size_t completedCount = 0;
+    
+    auto queue = execq::CreateOrderedExecutionQueue<int, void>(pool, 3, [&] (const std::atomic_bool&, int&& object) {
+        if (object == 0)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&] { return released; });
+        }
+        processedCount++;
+    }, [&] {
+        completedCount++;
+    });
+    
+    EXPECT_TRUE(queue->tryPush(0));
+    EXPECT_TRUE(queue->tryPush(1));
+    EXPECT_TRUE(queue->tryPush(2));
+    
+    // The first object holds up the window even if others are processed
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (processedCount < 2 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(processedCount, 2);
+    EXPECT_FALSE(queue->tryPush(3));
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        released = true;
+        condition.notify_all();
+    }
+    
+    // Blocking push waits for the window
+    for (int i = 3; i < 10; i++)
+    {
+        queue->push(int(i));
+    }
+    
+    queue.reset();
+    EXPECT_EQ(processedCount, 10);
+    EXPECT_EQ(completedCount, 10);
+}
+
+TEST(ExecutionPool, OrderedExecutionQueue_NullPool)
+{
+    EXPECT_THROW((execq::CreateOrderedExecutionQueue<int, int>(nullptr, 8, [] (const std::atomic_bool&, int&& object) {
+        return object;
+    }, [] (int&&) {})), std::invalid_argument);
+}
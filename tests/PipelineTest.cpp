@@ -0,0 +1,204 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+#include <gtest/gtest.h>
+
+TEST(ExecutionPool, Pipeline_Stages)
+{
+    std::shared_ptr<execq::IExecutionPool> pool = execq::CreateExecutionPool(4);
+    
+    std::vector<size_t> results;
+    std::atomic_int concurrentCount { 0 };
+    bool overlapped = false;
+    
+    std::unique_ptr<execq::IPipeline<std::string>> pipeline = execq::PipelineBuilder<std::string>(pool)
+    .parallel<size_t>(4, [] (const std::atomic_bool&, std::string&& object) {
+        return object.size();
+    })
+    .serial<void>(2, [&] (const std::atomic_bool&, size_t&& object) {
+        overlapped |= concurrentCount++ != 0;
+        results.push_back(object);
+        concurrentCount--;
+    })
+    .build();
+    
+    for (size_t i = 0; i < 100; i++)
+    {
+        pipeline->push(std::string(i, 'a'));
+    }
+    
+    pipeline.reset();
+    
+    EXPECT_FALSE(overlapped);
+    ASSERT_EQ(results.size(), 100);
+    
+    std::sort(results.begin(), results.end());
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        EXPECT_EQ(results[i], i);
+    }
+}
+
+TEST(ExecutionPool, Pipeline_Backpressure)
+{
+    std::shared_ptr<execq::IExecutionPool> pool = execq::CreateExecutionPool(2);
+    
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool released = false;
+    std::atomic_size_t processedCount { 0 };
+    
+    std::unique_ptr<execq::IPipeline<int>> pipeline = execq::PipelineBuilder<int>(pool)
+    .serial<int>(1, [] (const std::atomic_bool&, int&& object) {
+        return object;
+    })
+    .serial<void>(1, [&] (const std::atomic_bool&, int&&) {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&] { return released; });
+        processedCount++;
+    })
+    .build();
+    
+    // One object blocks the last stage, one waits in its buffer, one waits in the first stage buffer.
+    // First stage can't take next object because there is no space for the result.
+    size_t acceptedCount = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        if (pipeline->tryPush(int(acceptedCount)))
+        {
+            acceptedCount++;
+        }
+        else if (acceptedCount == 3)
+        {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    
+    EXPECT_EQ(acceptedCount, 3);
+    EXPECT_FALSE(pipeline->tryPush(100));
+    EXPECT_EQ(processedCount, 0);
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        released = true;
+        condition.notify_all();
+    }
+    
+    // Blocking push waits for free space
+    pipeline->push(3);
+    pipeline->push(4);
+    
+    pipeline.reset();
+    EXPECT_EQ(processedCount, 5);
+}
+
+TEST(ExecutionPool, Pipeline_MoveOnlyObjects)
+{
+    std::shared_ptr<execq::IExecutionPool> pool = execq::CreateExecutionPool(2);
+    
+    std::vector<int*> pushed;
+    std::vector<int*> received;
+    std::mutex mutex;
+    
+    std::unique_ptr<execq::IPipeline<std::unique_ptr<int>>> pipeline = execq::PipelineBuilder<std::unique_ptr<int>>(pool)
+    .parallel<std::unique_ptr<int>>(2, [] (const std::atomic_bool&, std::unique_ptr<int>&& object) {
+        (*object)++;
+        return std::move(object);
+    })
+    .parallel<void>(2, [&] (const std::atomic_bool&, std::unique_ptr<int>&& object) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back(object.get());
+        EXPECT_EQ(*object, 1);
+    })
+    .build();
+    
+    for (int i = 0; i < 10; i++)
+    {
+        std::unique_ptr<int> object(new int(0));
+        pushed.push_back(object.get());
+        pipeline->push(std::move(object));
+    }
+    
+    pipeline.reset();
+    
+    // Objects are moved, not reallocated
+    std::sort(pushed.begin(), pushed.end());
+    std::sort(received.begin(), received.end());
+    EXPECT_EQ(pushed, received);
+}
+
+TEST(ExecutionPool, Pipeline_NoStages)
+{
+    std::shared_ptr<execq::IExecutionPool> pool = execq::CreateExecutionPool(2);
+    
+    EXPECT_THROW(execq::PipelineBuilder<int>(pool).build(), std::runtime_error);
+}
+
+TEST(ExecutionPool, Pipeline_UsedBuilder)
+{
+    std::shared_ptr<execq::IExecutionPool> pool = execq::CreateExecutionPool(2);
+    
+    auto builder = execq::PipelineBuilder<int>(pool).parallel<size_t>(2, [] (const std::atomic_bool&, int&& object) {
+        return static_cast<size_t>(object);
+    });
+    auto nextBuilder = builder.serial<void>(2, [] (const std::atomic_bool&, size_t&&) {});
+    
+    // Stages have been moved to the next builder
+    EXPECT_THROW(builder.serial<void>(2, [] (const std::atomic_bool&, size_t&&) {}), std::logic_error);
+    EXPECT_THROW(builder.build(), std::logic_error);
+    EXPECT_NE(nextBuilder.build(), nullptr);
+    
+    // Stages have been moved to the pipeline
+    EXPECT_THROW(nextBuilder.build(), std::logic_error);
+}
+
+TEST(ExecutionPool, Pipeline_UsedBuilder_SameType)
+{
+    std::shared_ptr<execq::IExecutionPool> pool = execq::CreateExecutionPool(2);
+    
+    // Builder of the first stage is used as well when the stage doesn't change the type
+    execq::PipelineBuilder<int> builder(pool);
+    auto nextBuilder = builder.parallel<int>(2, [] (const std::atomic_bool&, int&& object) {
+        return object;
+    });
+    EXPECT_THROW(builder.parallel<int>(2, [] (const std::atomic_bool&, int&& object) { return object; }), std::logic_error);
+    EXPECT_THROW(builder.build(), std::logic_error);
+    
+    auto lastBuilder = nextBuilder.parallel<int>(2, [] (const std::atomic_bool&, int&& object) {
+        return object;
+    });
+    EXPECT_THROW(nextBuilder.parallel<int>(2, [] (const std::atomic_bool&, int&& object) { return object; }), std::logic_error);
+    EXPECT_NE(lastBuilder.build(), nullptr);
+    EXPECT_THROW(lastBuilder.parallel<int>(2, [] (const std::atomic_bool&, int&& object) { return object; }), std::logic_error);
+}
+
+TEST(ExecutionPool, Pipeline_NullPool)
+{
+    EXPECT_THROW(execq::PipelineBuilder<int>(nullptr), std::invalid_argument);
+}
@@ -0,0 +1,134 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+using namespace execq::test;
+
+TEST(ExecutionPool, TimedExecutionQueue_Debounce)
+{
+    auto pool = execq::CreateExecutionPool(2);
+    
+    std::mutex mutex;
+    std::vector<int> processed;
+    auto queue = execq::CreateDebouncedExecutionQueue<int, int>(pool, std::chrono::milliseconds(50), [&] (const std::atomic_bool&, int&& object) {
+        std::lock_guard<std::mutex> lock(mutex);
+        processed.push_back(object);
+        return object * 10;
+    });
+    
+    // Burst: only the latest object is processed after the quiet period
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 5; i++)
+    {
+        futures.push_back(queue->push(i));
+    }
+    
+    for (auto& future : futures)
+    {
+        ASSERT_EQ(future.wait_for(kTimeout), std::future_status::ready);
+        EXPECT_EQ(future.get(), 40);
+    }
+    
+    // Next burst
+    EXPECT_EQ(queue->push(5).get(), 50);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(processed, std::vector<int>({ 4, 5 }));
+}
+
+TEST(ExecutionPool, TimedExecutionQueue_Throttle)
+{
+    auto pool = execq::CreateExecutionPool(2);
+    
+    std::mutex mutex;
+    std::vector<std::pair<int, std::chrono::steady_clock::time_point>> processed;
+    auto queue = execq::CreateThrottledExecutionQueue<int, void>(pool, std::chrono::milliseconds(100), [&] (const std::atomic_bool&, int&& object) {
+        std::lock_guard<std::mutex> lock(mutex);
+        processed.emplace_back(object, std::chrono::steady_clock::now());
+    });
+    
+    // The first object is processed immediately, the latest of others - at the end of the window
+    std::future<void> first = queue->push(1);
+    std::future<void> second = queue->push(2);
+    std::future<void> third = queue->push(3);
+    
+    ASSERT_EQ(first.wait_for(kTimeout), std::future_status::ready);
+    ASSERT_EQ(second.wait_for(kTimeout), std::future_status::ready);
+    ASSERT_EQ(third.wait_for(kTimeout), std::future_status::ready);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(processed.size(), 2);
+    EXPECT_EQ(processed[0].first, 1);
+    EXPECT_EQ(processed[1].first, 3);
+    EXPECT_GE(processed[1].second - processed[0].second, std::chrono::milliseconds(90));
+}
+
+TEST(ExecutionPool, TimedExecutionQueue_PendingWhenDestroyed)
+{
+    auto pool = execq::CreateExecutionPool(2);
+    
+    std::atomic_int processedCount { 0 };
+    std::atomic_bool wasCanceled { false };
+    auto queue = execq::CreateDebouncedExecutionQueue<int, void>(pool, std::chrono::seconds(10), [&] (const std::atomic_bool& isCanceled, int&&) {
+        wasCanceled = isCanceled.load();
+        processedCount++;
+    });
+    
+    std::future<void> future = queue->push(1);
+    
+    // Pending object is not lost, it is processed as canceled
+    queue.reset();
+    EXPECT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    EXPECT_EQ(processedCount, 1);
+    EXPECT_TRUE(wasCanceled);
+}
+
+TEST(ExecutionPool, TimedExecutionQueue_DispatchSync)
+{
+    auto pool = execq::CreateExecutionPool(2);
+    
+    auto queue = execq::CreateDebouncedExecutionQueue<int, int>(pool, std::chrono::milliseconds(20), [] (const std::atomic_bool&, int&& object) {
+        return object * 10;
+    });
+    
+    EXPECT_EQ(queue->dispatchSync(1), 10);
+    
+    // All pool threads wait in 'dispatchSync': waiting threads help, nothing hangs
+    auto callerQueue = execq::CreateConcurrentExecutionQueue<int, int>(pool, [&] (const std::atomic_bool&, int&& object) {
+        return queue->dispatchSync(object);
+    });
+    std::future<int> result = callerQueue->push(2);
+    std::future<int> other = callerQueue->push(3);
+    
+    ASSERT_EQ(result.wait_for(kTimeout), std::future_status::ready);
+    ASSERT_EQ(other.wait_for(kTimeout), std::future_status::ready);
+    
+    // Objects are pushed concurrently: they may be debounced together or one by one
+    const int resultValue = result.get();
+    const int otherValue = other.get();
+    EXPECT_TRUE(resultValue == 20 || resultValue == 30);
+    EXPECT_TRUE(otherValue == 20 || otherValue == 30);
+}
@@ -0,0 +1,97 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Timer.h"
+#include "ExecqTestUtil.h"
+
+using namespace execq::test;
+
+TEST(ExecutionPool, Timer_Order)
+{
+    execq::impl::Timer timer;
+    
+    std::mutex mutex;
+    std::vector<int> fired;
+    std::promise<void> done;
+    
+    const auto now = std::chrono::steady_clock::now();
+    timer.schedule(now + std::chrono::milliseconds(30), [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        fired.push_back(3);
+        done.set_value();
+    });
+    timer.schedule(now + std::chrono::milliseconds(10), [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        fired.push_back(1);
+    });
+    timer.schedule(now + std::chrono::milliseconds(20), [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        fired.push_back(2);
+    });
+    
+    ASSERT_EQ(done.get_future().wait_for(kTimeout), std::future_status::ready);
+    EXPECT_GE(std::chrono::steady_clock::now() - now, std::chrono::milliseconds(30));
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(fired, std::vector<int>({ 1, 2, 3 }));
+}
+
+TEST(ExecutionPool, Timer_Cancel)
+{
+    execq::impl::Timer timer;
+    
+    std::atomic_bool canceledFired { false };
+    std::promise<void> done;
+    
+    const auto now = std::chrono::steady_clock::now();
+    const execq::impl::Timer::TimerId timerId = timer.schedule(now + std::chrono::milliseconds(10), [&] {
+        canceledFired = true;
+    });
+    timer.schedule(now + std::chrono::milliseconds(20), [&] {
+        done.set_value();
+    });
+    
+    timer.cancel(timerId);
+    
+    ASSERT_EQ(done.get_future().wait_for(kTimeout), std::future_status::ready);
+    EXPECT_FALSE(canceledFired);
+}
+
+TEST(ExecutionPool, Timer_CancelWaitsForCallback)
+{
+    execq::impl::Timer timer;
+    
+    std::promise<void> started;
+    std::atomic_bool finished { false };
+    
+    const execq::impl::Timer::TimerId timerId = timer.schedule(std::chrono::steady_clock::now(), [&] {
+        started.set_value();
+        WaitForLongTermJob();
+        finished = true;
+    });
+    
+    ASSERT_EQ(started.get_future().wait_for(kTimeout), std::future_status::ready);
+    timer.cancel(timerId);
+    EXPECT_TRUE(finished);
+}
@@ -0,0 +1,141 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Alkenso (Vladimir Vashurkin)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "execq.h"
+#include "ExecqTestUtil.h"
+
+using namespace execq::test;
+
+TEST(ExecutionPool, Topic_FanOut)
+{
+    auto executionPool = execq::CreateExecutionPool();
+    std::unique_ptr<execq::ITopic<std::string>> topic = execq::CreateTopic<std::string>(executionPool);
+    
+    std::mutex mutex;
+    std::vector<const std::string*> received1;
+    std::vector<const std::string*> received2;
+    
+    std::unique_ptr<execq::ISubscription> subscription1 = topic->subscribe([&] (const std::atomic_bool&, const std::string& event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received1.push_back(&event);
+    });
+    std::unique_ptr<execq::ISubscription> subscription2 = topic->subscribe([&] (const std::atomic_bool&, const std::string& event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received2.push_back(&event);
+    });
+    
+    auto event = std::make_shared<const std::string>("qwe");
+    topic->publish(event);
+    
+    // Destroying subscriptions waits for delivered events.
+    subscription1.reset();
+    subscription2.reset();
+    
+    ASSERT_EQ(received1.size(), 1);
+    ASSERT_EQ(received2.size(), 1);
+    
+    // The event is shared, not copied per subscriber.
+    EXPECT_EQ(received1[0], event.get());
+    EXPECT_EQ(received2[0], event.get());
+    
+    // No more deliveries after unsubscribe.
+    topic->publish("asd");
+    EXPECT_EQ(received1.size(), 1);
+}
+
+TEST(ExecutionPool, Topic_Ordered)
+{
+    auto executionPool = execq::CreateExecutionPool();
+    std::unique_ptr<execq::ITopic<int>> topic = execq::CreateTopic<int>(executionPool);
+    
+    std::vector<int> received;
+    std::unique_ptr<execq::ISubscription> subscription = topic->subscribe([&] (const std::atomic_bool&, const int& event) {
+        received.push_back(event);
+    });
+    
+    const int count = 100;
+    for (int i = 0; i < count; i++)
+    {
+        topic->publish(i);
+    }
+    
+    subscription.reset();
+    
+    ASSERT_EQ(received.size(), count);
+    for (int i = 0; i < count; i++)
+    {
+        EXPECT_EQ(received[i], i);
+    }
+}
+
+TEST(ExecutionPool, Topic_SlowSubscriberLag)
+{
+    auto executionPool = execq::CreateExecutionPool();
+    std::unique_ptr<execq::ITopic<int>> topic = execq::CreateTopic<int>(executionPool);
+    
+    std::promise<void> slowStarted;
+    std::promise<void> slowRelease;
+    std::shared_future<void> slowReleaseFuture = slowRelease.get_future().share();
+    std::vector<int> slowReceived;
+    
+    execq::SubscriptionOptions slowOptions;
+    slowOptions.maxLag = 3;
+    std::unique_ptr<execq::ISubscription> slowSubscription = topic->subscribe([&] (const std::atomic_bool&, const int& event) {
+        if (slowReceived.empty())
+        {
+            slowStarted.set_value();
+            slowReleaseFuture.wait();
+        }
+        slowReceived.push_back(event);
+    }, slowOptions);
+    
+    std::atomic_int fastCount { 0 };
+    execq::SubscriptionOptions fastOptions;
+    fastOptions.ordered = false;
+    std::unique_ptr<execq::ISubscription> fastSubscription = topic->subscribe([&] (const std::atomic_bool&, const int&) {
+        fastCount++;
+    }, fastOptions);
+    
+    topic->publish(0);
+    ASSERT_EQ(slowStarted.get_future().wait_for(kTimeout), std::future_status::ready);
+    
+    for (int i = 1; i <= 10; i++)
+    {
+        topic->publish(i);
+    }
+    
+    // Slow subscriber doesn't hold back the fast one.
+    fastSubscription.reset();
+    EXPECT_EQ(fastCount, 11);
+    
+    slowRelease.set_value();
+    slowSubscription.reset();
+    
+    EXPECT_EQ(slowReceived, std::vector<int>({ 0, 8, 9, 10 }));
+}
+
+TEST(ExecutionPool, Topic_NullPool)
+{
+    EXPECT_THROW(execq::CreateTopic<int>(nullptr), std::invalid_argument);
+}